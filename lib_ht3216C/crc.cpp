@@ -0,0 +1,12 @@
+#include "crc.hpp"
+
+uint16_t crc16(const uint8_t * bytes, int length){
+    uint16_t value = 0xffff;
+    for(int i = 0; i < length; i++){
+        value ^= bytes[i] << 8;
+        for(int bit = 0; bit < 8; bit++){
+            value = (value & 0x8000) ? (value << 1) ^ 0x1021 : value << 1;
+        }
+    }
+    return value;
+}
@@ -0,0 +1,15 @@
+#ifndef CRC_H
+#define CRC_H
+#include <cstdint>
+
+/// \brief
+/// This function returns the CRC-16-CCITT of a number of bytes
+/// \details
+/// The crc starts at 0xffff and uses the polynomial 0x1021, the highest bit of every byte first.
+/// It is used by the packets on the uart: unlike a sum of the bytes, a byte that is lost or moved changes the crc.
+/// @param bytes are the bytes.
+/// @param length is the number of bytes.
+/// @see link_protocol frame_protocol
+uint16_t crc16(const uint8_t * bytes, int length);
+
+#endif //CRC_H
@@ -1,4 +1,5 @@
 #include "drawables.hpp"
+#include <climits>
 
 drawable::drawable(hwlib::window &w, hwlib::xy location, hwlib::xy size, hwlib::xy bounce):
         w(w),
@@ -33,7 +34,42 @@ bool drawable::overlaps( const drawable & other ){
 
     return x_overlap && y_overlap;
 }
+int drawable::sweep(hwlib::xy mover, hwlib::xy from, hwlib::xy delta, hwlib::xy & face) const{
+    // the area where the moving object overlaps this object, the same bounds as overlaps().
+    const int low[2] = {int(location.x - mover.x) * sweep_one, int(location.y - mover.y) * sweep_one};
+    const int high[2] = {int(location.x + size.x) * sweep_one, int(location.y + size.y + 1) * sweep_one};
+    const int start[2] = {(int)from.x, (int)from.y};
+    const int move[2] = {(int)delta.x, (int)delta.y};
+    int enter = INT_MIN;
+    int exit = INT_MAX;
+    int axis = -1;
+    for(int a = 0; a < 2; a++){
+        if(move[a] == 0){
+            if(start[a] < low[a] || start[a] > high[a]){
+                return sweep_miss;
+            }
+            continue;
+        }
+        int near = (move[a] > 0) ? low[a] : high[a];
+        int far = (move[a] > 0) ? high[a] : low[a];
+        int t_near = (near - start[a]) * sweep_one / move[a];
+        int t_far = (far - start[a]) * sweep_one / move[a];
+        if(t_near > enter){
+            enter = t_near;
+            axis = a;
+        }
+        if(t_far < exit){
+            exit = t_far;
+        }
+    }
+    if(axis < 0 || enter < 0 || enter > sweep_one || enter > exit){
+        return sweep_miss;
+    }
+    face = (axis == 0) ? hwlib::xy(1, 0) : hwlib::xy(0, 1);
+    return enter;
+}
 hwlib::xy drawable::get_location(){return location;};
+hwlib::xy drawable::get_size(){return size;};
 
 line::line( hwlib::window & w, hwlib::xy  location, hwlib::xy  end, hwlib::xy bounce):
         drawable(w, location, end-location, bounce),
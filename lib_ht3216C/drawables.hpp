@@ -9,6 +9,13 @@
 /// This drawable class includes all the functions used in the other classes. most of them are overwritten to
 /// get their own shape etc.
 class drawable {
+public:
+    /// \brief
+    /// one whole tick, or one whole cell, in the units of sweep().
+    static const int sweep_one = 256;
+    /// \brief
+    /// the value sweep() returns when nothing is hit.
+    static const int sweep_miss = -1;
 protected:
     hwlib::window &w;
     hwlib::xy location;
@@ -51,8 +58,30 @@ public:
     /// this function returns if a object overlaps with another object.
     bool overlaps( const drawable & other );
     /// \brief
+    /// this function returns when a moving object hits this object.
+    /// \details
+    /// The moving object goes in a straight line from from to from + delta during one tick.
+    /// It hits this object at the first moment overlaps() would be true, this is the time of impact.
+    /// from and delta are in 1/sweep_one of a cell, so a path can start or end between two cells.
+    /// An object that already overlaps at the start of the path is not hit.
+    /// ~~~~~~~~~~~~~~~~~~~~~~.cpp
+    /// hwlib::xy face;
+    /// int time = paddle.sweep(hwlib::xy(1,1), location * drawable::sweep_one, speed * drawable::sweep_one, face);
+    /// ~~~~~~~~~~~~~~~~~~~~~~
+    /// @param mover is the size of the moving object.
+    /// @param from is the location of the moving object at the start of the tick.
+    /// @param delta is the distance the moving object travels during the tick.
+    /// @param face is set to (1,0) when the moving object hits a left or right side, or (0,1) for a top or bottom side.
+    /// @returns the time of impact in 1/sweep_one of the tick, or sweep_miss.
+    /// @see overlaps()
+    int sweep(hwlib::xy mover, hwlib::xy from, hwlib::xy delta, hwlib::xy & face) const;
+    /// \brief
     /// this function returns the location.
     hwlib::xy get_location();
+    /// \brief
+    /// this function returns the size.
+    /// @note the size of a line can be negative, when the end is left or above the start.
+    hwlib::xy get_size();
 };
 
 /// \brief
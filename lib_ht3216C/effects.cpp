@@ -0,0 +1,77 @@
+#include "effects.hpp"
+
+effects::effects(ht3216C & matrix, uint8_t rest):
+        matrix(matrix),
+        rest(rest),
+        level(rest){}
+
+void effects::brightness(uint8_t value){
+    // the ht3216C ignores a brightness above 15, level has to stay what the ht3216C shows.
+    if(value > 15){
+        value = 15;
+    }
+    if(value != level){
+        level = value;
+        matrix.set_brightness(level);
+    }
+}
+void effects::fade(uint8_t to, uint16_t ticks){
+    running = kind::fade;
+    low = level;
+    high = to;
+    period = (ticks > 0) ? ticks : 1;
+    tick = 0;
+}
+void effects::pulse(uint8_t low, uint8_t high, uint16_t ticks, uint16_t pulses){
+    running = kind::pulse;
+    this->low = low;
+    this->high = high;
+    period = (ticks > 1) ? ticks : 2;
+    count = pulses;
+    tick = 0;
+}
+void effects::blink(uint16_t ticks){
+    blink_ticks = ticks;
+    if(!blinking){
+        blinking = true;
+        matrix.blink(true);
+    }
+}
+void effects::stop(){
+    running = kind::none;
+    brightness(rest);
+    if(blinking){
+        blinking = false;
+        matrix.blink(false);
+    }
+}
+void effects::update(){
+    if(running == kind::fade){
+        tick++;
+        brightness(low + ((int)high - low) * tick / period);
+        if(tick >= period){
+            running = kind::none;
+        }
+    } else if(running == kind::pulse){
+        // a triangle from low to high and back in one period.
+        int half = period / 2;
+        int phase = tick % period;
+        int up = (phase <= half) ? phase : period - phase;
+        brightness(low + ((int)high - low) * up / half);
+        tick++;
+        if(count > 0 && tick >= count * period){
+            running = kind::none;
+            brightness(rest);
+        }
+    }
+    if(blinking && blink_ticks > 0){
+        blink_ticks--;
+        if(blink_ticks == 0){
+            blinking = false;
+            matrix.blink(false);
+        }
+    }
+}
+bool effects::busy(){
+    return running != kind::none || blinking;
+}
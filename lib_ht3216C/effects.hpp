@@ -0,0 +1,79 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+#include "hwlib.hpp"
+#include "ht3216C.hpp"
+
+/// \brief
+/// This class runs brightness and blink effects on the ht3216C
+/// \details
+/// The effects only use the SET_BRIGHTNESS, BLINK_ON and BLINK_OFF commands, the RAM of the ht3216C is never written again.
+/// A command is only send when the brightness or the blinking really changes.
+/// The effects are timed in ticks: call update() once every loop of the game.
+/// A new fade or pulse replaces the one that is running, blinking can run at the same time.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+/// effects flash(chip);
+/// flash.blink(20);
+/// for(;;){
+///     flash.update();
+///     hwlib::wait_ms(50);
+/// }
+///~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// @see ht3216C::set_brightness() ht3216C::blink()
+class effects{
+protected:
+    enum class kind{
+        none,
+        fade,
+        pulse
+    };
+    ht3216C & matrix;
+    uint8_t rest;
+    uint8_t level;
+    kind running = kind::none;
+    uint8_t low = 0;
+    uint8_t high = 0;
+    uint16_t period = 0;
+    uint16_t count = 0;
+    uint16_t tick = 0;
+    bool blinking = false;
+    uint16_t blink_ticks = 0;
+    /// \brief
+    /// this function sets the brightness, the command is only send when the brightness changes.
+    /// @param value is the brightness, above 15 it is 15.
+    void brightness(uint8_t value);
+public:
+    /// \brief
+    /// this constructor sets up the effects.
+    /// @param matrix is the ht3216C.
+    /// @param rest is the brightness when no effect is running, between 0 and 15.
+    /// @note the ht3216C needs to be at the rest brightness, like after initialize().
+    effects(ht3216C & matrix, uint8_t rest = 15);
+    /// \brief
+    /// this function fades from the current brightness to another brightness.
+    /// @param to is the brightness at the end, between 0 and 15.
+    /// @param ticks is the number of ticks the fade takes.
+    void fade(uint8_t to, uint16_t ticks);
+    /// \brief
+    /// this function pulses the brightness up and down.
+    /// @param low is the lowest brightness.
+    /// @param high is the highest brightness.
+    /// @param ticks is the number of ticks of one pulse.
+    /// @param pulses is the number of pulses, 0 pulses until stop().
+    /// @note after the last pulse the brightness goes back to rest.
+    void pulse(uint8_t low, uint8_t high, uint16_t ticks, uint16_t pulses = 0);
+    /// \brief
+    /// this function lets the ht3216C blink.
+    /// @param ticks is the number of ticks the ht3216C blinks, 0 blinks until stop().
+    void blink(uint16_t ticks = 0);
+    /// \brief
+    /// this function stops all effects, the brightness goes back to rest.
+    void stop();
+    /// \brief
+    /// this function runs the effects for one tick.
+    void update();
+    /// \brief
+    /// this function returns true when an effect is running.
+    bool busy();
+};
+
+#endif //EFFECTS_H
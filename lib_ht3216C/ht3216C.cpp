@@ -40,41 +40,150 @@ void grp::direction_flush(){
         p->direction_flush();
     }
 }
-write_to::write_to(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs):
+void display_list::clear(){
+    length = 0;
+    transactions = 0;
+    full = false;
+}
+void display_list::begin(){
+    if(full){
+        return;
+    }
+    if(transactions < max_transactions){
+        starts[transactions] = length;
+        transactions++;
+        starts[transactions] = length;
+    } else {
+        full = true;
+    }
+}
+void display_list::add(uint8_t number, uint16_t d){
+    if(full){
+        return;
+    }
+    if(transactions == 0 || length + number > max_bits){
+        // drop the half recorded transaction, only complete transactions stay in the list.
+        if(transactions > 0){
+            transactions--;
+            length = starts[transactions];
+        }
+        full = true;
+        return;
+    }
+    for (uint16_t bit = 1<<(number-1); bit; bit >>= 1) {
+        bits[length++] = (d & bit) ? 1 : 0;
+    }
+    starts[transactions] = length;
+}
+bool display_list::overflowed() const{
+    return full;
+}
+uint8_t display_list::size() const{
+    return transactions;
+}
+const uint8_t * display_list::data(uint8_t transaction) const{
+    return &bits[starts[transaction]];
+}
+uint16_t display_list::bits_in(uint8_t transaction) const{
+    return starts[transaction + 1] - starts[transaction];
+}
+
+write_to::write_to(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs, timing strobe, display_list * recording):
         write ( write),
         data ( data),
-        cs ( cs )
+        cs ( cs ),
+        strobe ( strobe ),
+        recording ( recording )
 {
-    cs.write(0);
+    if(recording){
+        recording->begin();
+    } else {
+        cs.write(0);
+    }
+}
+
+void write_to::pad(int_fast32_t ns, uint_fast32_t spins){
+    if(spins){
+        for(volatile uint_fast32_t i = spins; i > 0; i--){}
+    } else if(ns){
+        hwlib::wait_ns(ns);
+    }
 }
 
 void write_to::writeData(uint8_t number, uint16_t d){
+    if(recording){
+        recording->add(number, d);
+        return;
+    }
     for (uint16_t bit = 1<<(number-1); bit; bit >>= 1) {
         write.write(0);
         data.write((d & bit) ? 1 : 0);
+        pad(strobe.pad_low_ns, strobe.spin_low);
+        write.write(1);
+        pad(strobe.pad_high_ns, strobe.spin_high);
+    }
+}
+
+void write_to::writeBits(const uint8_t * bits, uint16_t number){
+    for (const uint8_t * end = bits + number; bits != end; bits++) {
+        write.write(0);
+        data.write(*bits);
+        pad(strobe.pad_low_ns, strobe.spin_low);
         write.write(1);
+        pad(strobe.pad_high_ns, strobe.spin_high);
     }
 }
 
 write_to::~write_to(){
-    cs.write(1);
+    if(!recording){
+        cs.write(1);
+    }
 }
 
-ht3216C::ht3216C(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs):
-        write_to(write, data, cs),
+command_batch & command_batch::add(uint8_t cmd){
+    if(number < max_commands){
+        list[number] = cmd;
+        number++;
+    }
+    return *this;
+}
+void command_batch::clear(){
+    number = 0;
+}
+uint8_t command_batch::size() const{
+    return number;
+}
+uint8_t command_batch::operator[](uint8_t i) const{
+    return list[i];
+}
+
+ht3216C::ht3216C(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs, timing strobe):
+        write_to(write, data, cs, strobe),
         write ( write),
         data ( data),
         cs ( cs ){}
 void ht3216C::cmd(uint8_t cmd){
-    write_to command(write, data, cs);
+    write_to command(write, data, cs, strobe, recording);
     command.writeData(commands::total_command_length, (((uint16_t)commands::command_id << 8) | cmd) << 1 );
 }
+void ht3216C::cmd(const command_batch & batch){
+    if(batch.size() == 0){
+        return;
+    }
+    write_to command(write, data, cs, strobe, recording);
+    command.writeData(commands::id_length, commands::command_id);
+    for(uint8_t i = 0; i < batch.size(); i++){
+        command.writeData(commands::command_length, (uint16_t)batch[i] << 1);
+    }
+}
 void ht3216C::initialize(){
-    cmd(); //sys_en
-    cmd(commands::LED_ON); //led_on
-    cmd(commands::BLINK_OFF); // blink_off
-    cmd(commands::MASTERMODE); //mastermode
-    cmd(commands::COMOPTION); //com_option
+    command_batch batch;
+    batch.add(commands::SYS_EN)
+         .add(commands::LED_ON)
+         .add(commands::BLINK_OFF)
+         .add(commands::MASTERMODE)
+         .add(commands::COMOPTION);
+    cmd(batch);
     clear(); //clear matrix
 }
 void ht3216C::shutdown_leds(){
@@ -83,22 +192,31 @@ void ht3216C::shutdown_leds(){
 void ht3216C::shutdown(){
     cmd(commands::SYS_DIS);
 }
+void ht3216C::wake(){
+    command_batch batch;
+    batch.add(commands::SYS_EN).add(commands::LED_ON);
+    cmd(batch);
+}
 void ht3216C::clear(){
-    write_to command(write, data, cs);
+    write_to command(write, data, cs, strobe, recording);
     command.writeData(commands::id_length, commands::write_id);
     command.writeData(commands::addr_length, 0x00);
     for(int i = 0; i < commands::com; i++){
         command.writeData(commands::row, 0x0000);
         window[i] = 0x0000;
+        shown[i] = 0x0000;
     }
+    shown_valid = true;
 }
 void ht3216C::fill(){
-    write_to command(write, data, cs);
+    write_to command(write, data, cs, strobe, recording);
     command.writeData(3, 0x05);
     command.writeData(7, 0x00);
     for(int i = 0; i < commands::com; i++){
         command.writeData(commands::row, 0xffff);
+        shown[i] = 0xffff;
     }
+    shown_valid = true;
 }
 
 void ht3216C::set_brightness(uint8_t brightness){
@@ -107,29 +225,167 @@ void ht3216C::set_brightness(uint8_t brightness){
         cmd(value);
     }
 }
+void ht3216C::blink(bool on){
+    cmd(on ? commands::BLINK_ON : commands::BLINK_OFF);
+}
+uint16_t * ht3216C::plane(){
+    return (active == layer::background) ? background : window;
+}
+void ht3216C::select_layer(layer l){
+    active = l;
+}
+void ht3216C::clear_background(){
+    for(int i = 0; i < commands::com; i++){
+        background[i] = 0x0000;
+    }
+}
 void ht3216C::set_pixel(hwlib::xy xy){
     if(!((xy.x < 0) || (xy.x >= commands::row) || (xy.y < 0) || (xy.y >= commands::com)) ){
-        window[xy.y] |= 0x0001 << xy.x;
+        plane()[xy.y] |= 0x0001 << xy.x;
     }
 }
 void ht3216C::clear_pixel(hwlib::xy xy){
     if(!((xy.x < 0) || (xy.x >= commands::row) || (xy.y < 0) || (xy.y >= commands::com)) ){
-        window[xy.y] |= 0b0 << xy.x;
+        plane()[xy.y] |= 0b0 << xy.x;
     }
 }
+void ht3216C::write_row(uint8_t row, uint16_t bits){
+    if(row < commands::com){
+        plane()[row] |= bits;
+    }
+}
+void ht3216C::scroll(uint16_t column, uint16_t mask){
+    for(int i = 0; i < commands::com - 1; i++){
+        background[i] = (background[i] & ~mask) | (background[i + 1] & mask);
+    }
+    background[commands::com - 1] = (background[commands::com - 1] & ~mask) | (column & mask);
+}
 void ht3216C::flush(){
-    write_to command(write, data, cs);
-    command.writeData(commands::id_length, commands::write_id);
-    command.writeData(commands::addr_length, 0x00);
     for(int i = 0; i < commands::com; i++){
-        command.writeData(commands::row, window[i]);
+        window[i] |= background[i];
+    }
+    int first = 0;
+    int last = commands::com - 1;
+    if(shown_valid){
+        while(first < commands::com && window[first] == shown[first]){
+            first++;
+        }
+        while(last > first && window[last] == shown[last]){
+            last--;
+        }
+    }
+    if(first < commands::com){
+        write_to command(write, data, cs, strobe, recording);
+        command.writeData(commands::id_length, commands::write_id);
+        command.writeData(commands::addr_length, first * commands::addresses_per_row);
+        for(int i = first; i <= last; i++){
+            command.writeData(commands::row, window[i]);
+            shown[i] = window[i];
+        }
+        shown_valid = true;
+    }
+    for(int i = 0; i < commands::com; i++){
         window[i] = 0x0;
     }
+}
+void ht3216C::invalidate(){
+    shown_valid = false;
+}
+int_fast32_t ht3216C::calibrate(){
+    const int words = 256;
+    const int_fast32_t bits = words * commands::row;
+    const uint_fast32_t rounds = 100000;
+    auto bit_time = [&](){
+        uint_fast64_t start = hwlib::now_us();
+        for(int i = 0; i < words; i++){
+            writeData(commands::row, 0xaaaa);
+        }
+        return (int_fast32_t)(((hwlib::now_us() - start) * 1000) / bits);
+    };
+    cs.write(1);
+    strobe = timing();
+    strobe.pad_low_ns = 0;
+    strobe.pad_high_ns = 0;
+    // one bit without pads is 3 pin writes and the loop, the same loop with 1 pin write gives the time of the loop.
+    int_fast32_t bare_ns = bit_time();
+    uint_fast64_t start = hwlib::now_us();
+    for(int_fast32_t i = 0; i < bits; i++){
+        data.write(i & 1);
+    }
+    int_fast32_t single_ns = ((hwlib::now_us() - start) * 1000) / bits;
+    int_fast32_t pin_ns = (bare_ns - single_ns) / 2;
+    int_fast32_t loop_ns = single_ns - pin_ns;
+    pin_ns = (pin_ns > 0) ? pin_ns : 0;
+    loop_ns = (loop_ns > 0) ? loop_ns : 0;
+
+    // one round of the busy loop, rounded down so the pads wait at least as long as asked.
+    start = hwlib::now_us();
+    pad(0, rounds);
+    strobe.spin_ns = ((hwlib::now_us() - start) * 1000) / rounds;
+    strobe.spin_ns = (strobe.spin_ns > 0) ? strobe.spin_ns : 1;
+    auto spins = [&](int_fast32_t ns){
+        return (ns > 0) ? (uint_fast32_t)((ns + strobe.spin_ns - 1) / strobe.spin_ns) : 0;
+    };
 
+    // while low there is only the data write, the data is only known to be stable after that write.
+    int_fast32_t low = strobe.wr_low_ns - pin_ns;
+    strobe.spin_low = spins((low > strobe.setup_ns) ? low : strobe.setup_ns);
+    // while high there is the loop and the falling edge of the next bit, the data changes after that.
+    int_fast32_t high = strobe.wr_high_ns - loop_ns - pin_ns;
+    int_fast32_t hold = strobe.hold_ns - loop_ns - pin_ns;
+    strobe.spin_high = spins((high > hold) ? high : hold);
+    strobe.pad_low_ns = strobe.spin_low * strobe.spin_ns;
+    strobe.pad_high_ns = strobe.spin_high * strobe.spin_ns;
+
+    // measure what the pads really wait, with only the low pad and with both pads.
+    uint_fast32_t spin_high = strobe.spin_high;
+    int_fast32_t pad_high_ns = strobe.pad_high_ns;
+    strobe.spin_high = 0;
+    strobe.pad_high_ns = 0;
+    int_fast32_t low_wait_ns = bit_time() - bare_ns;
+    strobe.spin_high = spin_high;
+    strobe.pad_high_ns = pad_high_ns;
+    strobe.bit_ns = bit_time();
+    int_fast32_t high_wait_ns = strobe.bit_ns - bare_ns - low_wait_ns;
+
+    int_fast32_t low_ns = pin_ns + low_wait_ns;
+    int_fast32_t high_ns = high_wait_ns + loop_ns + pin_ns;
+    if(strobe.bit_ns < strobe.wr_low_ns + strobe.wr_high_ns
+       || low_ns < strobe.wr_low_ns || low_wait_ns < strobe.setup_ns
+       || high_ns < strobe.wr_high_ns || high_ns < strobe.hold_ns){
+        strobe = timing();
+        return 0;
+    }
+    return strobe.bit_ns;
+}
+void ht3216C::record(display_list & list){
+    list.clear();
+    recording = &list;
+    invalidate();
+}
+void ht3216C::stop_recording(){
+    recording = nullptr;
+    invalidate();
+}
+void ht3216C::replay(const display_list & list){
+    for(uint8_t i = 0; i < list.size(); i++){
+        replay(list, i);
+    }
+}
+void ht3216C::replay(const display_list & list, uint8_t transaction){
+    if(!list.overflowed() && transaction < list.size()){
+        write_to command(write, data, cs, strobe);
+        command.writeBits(list.data(transaction), list.bits_in(transaction));
+    }
+    invalidate();
+}
+timing ht3216C::get_timing(){
+    return strobe;
 }
 void ht3216C::change_window(uint16_t w[24]) {
-    for (int i = 0; i <= 24; ++i) {
-        window[i] = w[i];
+    uint16_t * rows = plane();
+    for (int i = 0; i < commands::com; ++i) {
+        rows[i] = w[i];
     }
 }
 
@@ -145,6 +401,9 @@ void window::write_implementation(hwlib::xy pixel, hwlib::color col){
         matrix.set_pixel(pixel);
     }
 }
+void window::select_layer(layer l){
+    matrix.select_layer(l);
+}
 void window::flush(){
     matrix.flush();
 }
@@ -193,14 +452,18 @@ void window::test_function(){
         this->flush();
         hwlib::wait_ms(100);
     }
+    display_list ramp;
+    matrix.record(ramp);
     for(uint8_t brightness = 0; brightness <= 15; brightness++){
         matrix.set_brightness(brightness);
-        matrix.fill();
-        hwlib::wait_ms(200);
     }
     for(uint8_t brightness = 0; brightness <= 15; brightness++){
         matrix.set_brightness(15 - brightness);
-        matrix.fill();
+    }
+    matrix.stop_recording();
+    matrix.fill();
+    for(uint8_t step = 0; step < ramp.size(); step++){
+        matrix.replay(ramp, step);
         hwlib::wait_ms(200);
     }
     matrix.shutdown();
@@ -14,6 +14,8 @@ struct commands{
     static const int com = 24;
     static const int row = 16;
     static const int total_command_length = 12;
+    static const int command_length = 9;
+    static const int addresses_per_row = 4;
 
     static const uint8_t write_id = 0x05;
     static const uint8_t command_id = 0x04;
@@ -31,6 +33,87 @@ struct commands{
     static const uint8_t COMOPTION = 0x24;
 };
 
+/// \brief
+/// struct with the timing of the write strobe
+/// \details
+/// this struct contains the minimum times of the write strobe in ns.
+/// The default minimums are the write mode limits of the HT1632C datasheet at VDD = 5V.
+/// pad_low_ns and pad_high_ns are the extra waits that write_to::writeData() adds to reach these minimums.
+/// They start at the full minimum, which is always safe, and are waited with hwlib::wait_ns().
+/// wait_ns() on the arduino due only waits whole microseconds, so ht3216C::calibrate() replaces them by
+/// spin_low and spin_high: a number of rounds of a busy loop, which can wait a part of a microsecond.
+/// @see write_to ht3216C::calibrate()
+struct timing{
+    /// minimum time the write pin is low.
+    int_fast32_t wr_low_ns = 835;
+    /// minimum time the write pin is high.
+    int_fast32_t wr_high_ns = 835;
+    /// minimum time the data is stable before the rising edge of the write pin.
+    int_fast32_t setup_ns = 500;
+    /// minimum time the data is stable after the rising edge of the write pin.
+    int_fast32_t hold_ns = 500;
+    /// extra wait while the write pin is low.
+    int_fast32_t pad_low_ns = 835;
+    /// extra wait while the write pin is high.
+    int_fast32_t pad_high_ns = 835;
+    /// rounds of the busy loop while the write pin is low, when not 0 these are used instead of pad_low_ns.
+    uint_fast32_t spin_low = 0;
+    /// rounds of the busy loop while the write pin is high, when not 0 these are used instead of pad_high_ns.
+    uint_fast32_t spin_high = 0;
+    /// measured time of one round of the busy loop in ns, 0 when not calibrated.
+    int_fast32_t spin_ns = 0;
+    /// measured time of one bit, 0 when not calibrated.
+    int_fast32_t bit_ns = 0;
+};
+
+/// \brief
+/// This class is a recorded list of transactions for the ht3216C
+/// \details
+/// While an ht3216C is recording, every transaction is stored in this list instead of written to the pins.
+/// Every bit is stored in its own byte, already as the value of the data pin.
+/// Replaying the list only toggles the pins, nothing is shifted or masked anymore.
+/// @see ht3216C::record() ht3216C::replay()
+class display_list{
+public:
+    static const int max_bits = 1024;
+    static const int max_transactions = 32;
+protected:
+    std::array< uint8_t, max_bits> bits;
+    std::array< uint16_t, max_transactions + 1> starts;
+    uint16_t length = 0;
+    uint8_t transactions = 0;
+    bool full = false;
+public:
+    /// \brief
+    /// This function empties the list.
+    void clear();
+    /// \brief
+    /// This function starts a new transaction in the list.
+    /// @note when the list is full the transaction is not added.
+    void begin();
+    /// \brief
+    /// This function adds bits to the last transaction.
+    /// @param number is the number of bits in d.
+    /// @param d are the bits, the highest bit first.
+    /// @note when the list is full the half recorded transaction is removed, and no bits are added after it.
+    void add(uint8_t number, uint16_t d);
+    /// \brief
+    /// This function tells if transactions were lost because the list was full.
+    /// @returns true when the list is not complete, an overflowed list is not replayed.
+    bool overflowed() const;
+    /// \brief
+    /// This function returns the number of transactions in the list.
+    uint8_t size() const;
+    /// \brief
+    /// This function returns the first bit of a transaction.
+    /// @param transaction is the number of the transaction.
+    const uint8_t * data(uint8_t transaction) const;
+    /// \brief
+    /// This function returns the number of bits of a transaction.
+    /// @param transaction is the number of the transaction.
+    uint16_t bits_in(uint8_t transaction) const;
+};
+
 /// \brief
 /// This class is a collection of all the used pins
 /// \details
@@ -88,31 +171,98 @@ protected:
     hwlib::pin_in_out &write;
     hwlib::pin_in_out &data;
     hwlib::pin_in_out &cs;
+    timing strobe;
+    display_list * recording;
+    /// \brief
+    /// This function waits while the write pin is low or high
+    /// \details
+    /// When spins is not 0 the busy loop runs that many rounds, otherwise ns is waited with hwlib::wait_ns().
+    /// @param ns is the pad in ns.
+    /// @param spins are the rounds of the busy loop.
+    /// @see timing
+    static void pad(int_fast32_t ns, uint_fast32_t spins);
 public:
     /// \brief
     /// This is the constructor for this class
     /// \details
     /// This constructor is used to set up this class
     /// It also starts the writing sequence by lowering the Chip Select pin
-    write_to(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs);
+    /// @param strobe is the timing of the write pin. The default is the safe datasheet timing.
+    /// @param recording is the display_list the transaction is stored in, when it is not a nullptr the pins are not written.
+    write_to(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs, timing strobe = timing(), display_list * recording = nullptr);
 
     /// \brief
     /// This function is used to write the actual data to the ht3216C
     /// \details
     /// This function runs bit by bit through the data
     /// The data pin is set high when the current bit is a 1 and a 0 if the current bit is low.
-    /// For every bit the write pin is pulsed.
+    /// For every bit the write pin is pulsed. The pulse is stretched by the pads in the timing.
     /// @param number is the number of bits in data. (unsigned int, 8bits)
     /// @param d is the actual data that needs to be send. (unsigned int, 16bits)
     /// @note as long as the destructor is not activated this function can be called again.
     void writeData(uint8_t aantal, uint16_t d);
     /// \brief
+    /// This function writes bits that are already encoded
+    /// \details
+    /// Every byte is the value of the data pin for one bit, for every bit the write pin is pulsed.
+    /// @param bits are the encoded bits.
+    /// @param number is the number of bits.
+    /// @see display_list
+    void writeBits(const uint8_t * bits, uint16_t number);
+    /// \brief
     /// This is the destructor of this class
     /// \details
     /// This destructor sets the Chip Select high, therefore the data transaction has ended.
     ~write_to();
 };
 /// \brief
+/// the layers of the ht3216C
+/// \details
+/// dynamic is the layer that is redrawn every frame, it is reset by every flush.
+/// background is the layer with the static content. It is drawn once and kept until clear_background().
+/// When a frame is written, both layers are combined with a row-wise OR.
+/// @see ht3216C::select_layer() ht3216C::flush()
+enum class layer{
+    dynamic,
+    background
+};
+
+/// \brief
+/// This class is a list of commands for the ht3216C
+/// \details
+/// The ht3216C accepts more than one command after a single command id.
+/// The commands in this list are send by ht3216C::cmd() in one transaction,
+/// so the Chip Select and the command id are only written once.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+/// command_batch batch;
+/// batch.add(commands::SYS_EN).add(commands::LED_ON);
+/// matrix.cmd(batch);
+///~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// @see ht3216C::cmd() commands
+class command_batch{
+public:
+    static const int max_commands = 16;
+protected:
+    std::array< uint8_t, max_commands> list;
+    uint8_t number = 0;
+public:
+    /// \brief
+    /// This function adds a command to the list.
+    /// @param cmd is an 8 bit command.
+    /// @note when the list is full the command is ignored.
+    /// @returns the list itself, so more commands can be added.
+    command_batch & add(uint8_t cmd);
+    /// \brief
+    /// This function empties the list.
+    void clear();
+    /// \brief
+    /// This function returns the number of commands in the list.
+    uint8_t size() const;
+    /// \brief
+    /// This function returns the command at place i.
+    uint8_t operator[](uint8_t i) const;
+};
+/// \brief
 /// This is the class for the ht3216C
 /// \details
 /// this class gives full control over the ledmatrix when writing data.
@@ -123,25 +273,41 @@ protected:
     hwlib::pin_in_out &data;
     hwlib::pin_in_out &cs;
     uint16_t window[24] = {0};
+    uint16_t background[24] = {0};
+    uint16_t shown[24] = {0};
+    bool shown_valid = false;
+    layer active = layer::dynamic;
+    /// \brief
+    /// This function returns the rows of the selected layer.
+    uint16_t * plane();
 public:
     /// \brief
     /// This is the constructor of this class
     /// \details
     /// This constructor sets up this class, and the write_to class.
     /// @note All the pin_in_out's need to be on output mode.
-    ht3216C(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs);
+    /// @param strobe is the timing of the write pin, used for every transaction.
+    ht3216C(hwlib::pin_in_out &write, hwlib::pin_in_out &data, hwlib::pin_in_out & cs, timing strobe = timing());
     /// \brief
     /// This function sends a command to the ht3216C.
     /// @see commands writeData()
     /// @param cmd is an 8 bit command. The default value is the SYS_EN. Used to enable the system.
     void cmd(uint8_t cmd = commands::SYS_EN);
     /// \brief
+    /// This function sends a list of commands to the ht3216C.
+    /// \details
+    /// All the commands are written after one command id in one transaction.
+    /// @see command_batch commands writeData()
+    /// @param batch is the list of commands.
+    void cmd(const command_batch & batch);
+    /// \brief
     /// This function initializes the full ht3216C system
     /// \details
     /// In this function the SYS_EN command is executed
     /// after that the LED_ON, BLINK_OFF, MASTERMODE and COMOPTION.
+    /// These are send in one command_batch.
     /// It also resets the RAM data on the ht3216C.
-    /// @see cmd() commands clear()
+    /// @see cmd() command_batch commands clear()
     void initialize();
     /// \brief
     /// This function turns off the leds.
@@ -156,6 +322,13 @@ public:
     /// @see cmd() commands
     void shutdown();
     /// \brief
+    /// This function turns the system and the leds back on
+    /// \details
+    /// This function sends the SYS_EN and the LED_ON command to the ht3216C.
+    /// The RAM data is kept during shutdown(), so the last frame is shown again.
+    /// @see shutdown() shutdown_leds()
+    void wake();
+    /// \brief
     /// This function fills the RAM data with zeros
     /// \details
     /// This function is writes all zeros to the ht3216C, starting from addres zero to the last register.
@@ -177,9 +350,29 @@ public:
     /// @see commands cmd()
     void set_brightness(uint8_t brightness);
     /// \brief
+    /// This function turns blinking on or off
+    /// \details
+    /// This function sends the BLINK_ON or BLINK_OFF command, the ht3216C blinks all leds by itself.
+    /// @param on is true to start blinking, false to stop.
+    /// @see commands cmd()
+    void blink(bool on);
+    /// \brief
+    /// This function selects the layer that is drawn on
+    /// \details
+    /// set_pixel(), clear_pixel() and change_window() change the selected layer.
+    /// Draw the static content once on the background layer, and select the dynamic layer again.
+    /// @param l is the layer to draw on.
+    /// @see layer clear_background()
+    void select_layer(layer l);
+    /// \brief
+    /// This function empties the background layer
+    /// @note Set up function, doesn't write anything.
+    /// @see layer select_layer()
+    void clear_background();
+    /// \brief
     /// This function writes a 1 to a coordinate in window
     /// \details
-    /// This function changes the value of the uint16_t array window.
+    /// This function changes the value of the uint16_t array of the selected layer.
     /// when all the pixels are set the flush() function writes it to the ht3216C.
     /// @note Set up function, doesn't write anything.
     /// @param xy is an hwlib::xy with a x value and a y value. these can't be bigger than the led matrix
@@ -188,22 +381,104 @@ public:
     /// \brief
     /// This function writes a 0 to a coordinate in window
     /// \details
-    /// This function changes the value of the uint16_t array window.
+    /// This function changes the value of the uint16_t array of the selected layer.
     /// when all the pixels are set/reset the flush() function writes it to the ht3216C.
     /// @note Set up function, doesn't write anything.
     /// @param xy is an hwlib::xy with a x value and a y value. these can't be bigger than the led matrix
     /// @see flush() set_pixel()
     void clear_pixel(hwlib::xy xy);
     /// \brief
+    /// This function writes a whole row at once
+    /// \details
+    /// This function ORs the bits with the row of the selected layer.
+    /// @note Set up function, doesn't write anything.
+    /// @param row is the row (com) between 0 and 23.
+    /// @param bits are the pixels of the row, bit 0 is x = 0.
+    /// @see set_pixel() flush()
+    void write_row(uint8_t row, uint16_t bits);
+    /// \brief
+    /// This function scrolls a part of the background layer by one row
+    /// \details
+    /// Only the bits in mask are moved: every row gets the bits of the next row, the last row gets column.
+    /// The other bits of the background layer are kept.
+    /// This moves 24 row words, no pixels are drawn.
+    /// @note Set up function, doesn't write anything.
+    /// @param column are the new bits for the last row.
+    /// @param mask are the bits that are scrolled.
+    /// @see layer flush()
+    void scroll(uint16_t column, uint16_t mask);
+    /// \brief
     /// This function writes the window values to the ht3216C
     /// \details
     /// This function writes the values in window to the ht3216C. It also resets the window.
-    /// @see set_pixel write_to
+    /// Every row is the OR of the dynamic and the background layer, the background layer is kept.
+    /// Only the rows from the first to the last changed row are written.
+    /// When nothing has changed since the last flush, nothing is written at all.
+    /// @see set_pixel write_to invalidate()
     void flush();
     /// \brief
+    /// This function forgets what is shown on the ht3216C
+    /// \details
+    /// After this function the next flush() writes all the rows again.
+    /// Use this when the RAM data on the ht3216C is changed without flush().
+    /// @see flush()
+    void invalidate();
+    /// \brief
+    /// This function measures the write strobe and sets the pads to the minimum
+    /// \details
+    /// First the bits are written without any pad, and only the data pin is written in the same loop.
+    /// Together these give the time of one pin write and the time of the loop itself, the loop is counted in the high phase.
+    /// Then the time of one round of the busy loop is measured, and the pads are set to the rounds that
+    /// are needed so every minimum in the timing is met.
+    /// At last the bits are written again to measure what the pads really wait.
+    /// When the bit time or one of the phases is below its minimum the safe default pads are put back.
+    /// While measuring the Chip Select pin is high, so the ht3216C ignores the bits.
+    /// @warning the measurement can't see the pins themselves. Only call this once tools/trace_check
+    /// passes on a logic analyzer capture of a flush() after calibrating, otherwise keep the default timing().
+    /// @returns the measured time of one bit in ns, or 0 when the default pads are used.
+    /// @see timing get_timing()
+    int_fast32_t calibrate();
+    /// \brief
+    /// This function starts recording
+    /// \details
+    /// After this function every transaction is added to the list instead of written to the ht3216C.
+    /// Everything that is shown is forgotten, so the first flush() records all the rows.
+    /// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+    /// display_list start;
+    /// matrix.record(start);
+    /// matrix.initialize();
+    /// matrix.stop_recording();
+    /// matrix.replay(start);
+    ///~~~~~~~~~~~~~~~~~~~~~~~~~~
+    /// @param list is the list the transactions are added to, it is emptied first.
+    /// @see display_list stop_recording() replay()
+    void record(display_list & list);
+    /// \brief
+    /// This function stops recording, the transactions are written to the ht3216C again.
+    /// @see record()
+    void stop_recording();
+    /// \brief
+    /// This function writes all the transactions of a list to the ht3216C.
+    /// \details
+    /// Afterwards the ht3216C doesn't know what is shown, so the next flush() writes all the rows.
+    /// @note nothing is written when the list has overflowed, a list with missing transactions would show something else.
+    /// @see record() invalidate() display_list::overflowed()
+    void replay(const display_list & list);
+    /// \brief
+    /// This function writes one transaction of a list to the ht3216C.
+    /// @note nothing is written when the list has overflowed.
+    /// @param list is the recorded list.
+    /// @param transaction is the number of the transaction.
+    /// @see record() invalidate()
+    void replay(const display_list & list, uint8_t transaction);
+    /// \brief
+    /// This function returns the timing used for the write pin.
+    /// @see timing calibrate()
+    timing get_timing();
+    /// \brief
     /// This function overrites the window
     /// \details
-    /// This function changes the window to the parameter. therefore the window can be written by hand.
+    /// This function changes the selected layer to the parameter. therefore the window can be written by hand.
     /// @see flush()
     /// @param w new (hardcoded) window.
     void change_window(uint16_t w[24]);
@@ -231,6 +506,19 @@ public:
     /// @see ht3216C::set_pixel()
     void write_implementation(hwlib::xy pixel, hwlib::color col = {255,0,0}) override;
     /// \brief
+    /// This function selects the layer that is drawn on.
+    /// \details
+    /// Everything drawn on this window after selecting layer::background stays on the matrix,
+    /// without drawing it again every frame.
+    /// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+    /// w.select_layer(layer::background);
+    /// line middle(w, hwlib::xy(0, 12), hwlib::xy(16, 12));
+    /// middle.draw();
+    /// w.select_layer(layer::dynamic);
+    ///~~~~~~~~~~~~~~~~~~~~~~~~~~
+    /// @see ht3216C::select_layer()
+    void select_layer(layer l);
+    /// \brief
     /// This function flushes the matrix.
     /// @see ht3216C::flush()
     void flush() override;
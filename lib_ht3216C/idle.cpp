@@ -0,0 +1,79 @@
+#include "idle.hpp"
+
+idle_scheduler::idle_scheduler(ht3216C & matrix, uint_fast64_t timeout_ms, int_fast32_t poll_ms, hwlib::pin_in & b0, hwlib::pin_in & b1, hwlib::pin_in & b2, hwlib::pin_in & b3):
+        matrix(matrix),
+        buttons{ &b0, &b1, &b2, &b3},
+        timeout_us(timeout_ms * 1000),
+        poll_ms(poll_ms),
+        last_activity(hwlib::now_us()),
+        last_state(read_buttons()){}
+
+uint8_t idle_scheduler::read_buttons(){
+    uint8_t state = 0;
+    for(unsigned int i = 0; i < buttons.size(); i++){
+        buttons[i]->refresh();
+        if(buttons[i]->read()){
+            state |= 0x01 << i;
+        }
+    }
+    return state;
+}
+void idle_scheduler::wake_on(hwlib::target::pins pin){
+    if(wake_pins < wake_ports.size()){
+        const auto & info = hwlib::target::pin_info(pin);
+        wake_ports[wake_pins] = &hwlib::target::port_registers(info.port);
+        wake_masks[wake_pins] = 0x1U << info.pin;
+        wake_pins++;
+    }
+}
+bool idle_scheduler::update(){
+    uint8_t state = read_buttons();
+    if(state != last_state){
+        last_state = state;
+        last_activity = hwlib::now_us();
+        return false;
+    }
+    if(hwlib::now_us() - last_activity < timeout_us){
+        return false;
+    }
+    turn_off();
+    return true;
+}
+void idle_scheduler::turn_off(){
+    command_batch batch;
+    batch.add(commands::LED_OFF).add(commands::SYS_DIS);
+    matrix.cmd(batch);
+    uint8_t state = read_buttons();
+    if(wake_pins > 0){
+        SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+        for(uint8_t i = 0; i < wake_pins; i++){
+            wake_ports[i]->PIO_IER = wake_masks[i];
+        }
+        while(state == last_state){
+            // reading PIO_ISR clears the changes, the buttons are read after that so no change is missed.
+            for(uint8_t i = 0; i < wake_pins; i++){
+                (void)wake_ports[i]->PIO_ISR;
+            }
+            for(IRQn_Type irq = PIOA_IRQn; irq <= PIOD_IRQn; irq = (IRQn_Type)(irq + 1)){
+                NVIC_ClearPendingIRQ(irq);
+            }
+            state = read_buttons();
+            if(state == last_state){
+                __WFE();
+                state = read_buttons();
+            }
+        }
+        for(uint8_t i = 0; i < wake_pins; i++){
+            wake_ports[i]->PIO_IDR = wake_masks[i];
+        }
+        SCB->SCR &= ~SCB_SCR_SEVONPEND_Msk;
+    } else {
+        while(state == last_state){
+            hwlib::wait_ms(poll_ms);
+            state = read_buttons();
+        }
+    }
+    last_state = state;
+    last_activity = hwlib::now_us();
+    matrix.wake();
+}
@@ -0,0 +1,73 @@
+#ifndef IDLE_H
+#define IDLE_H
+#include "hwlib.hpp"
+#include "ht3216C.hpp"
+
+/// \brief
+/// This class turns the ht3216C off when nobody is playing
+/// \details
+/// This class watches the buttons. When none of the buttons changes for the given time,
+/// the leds and the system of the ht3216C are turned off and the buttons are only checked now and then.
+/// When any button changes the ht3216C is turned back on and the game continues where it was.
+/// The saving is mostly in the led drive: the startscreen has 106 leds on, at about 20 mA peak and 1/16 duty that is
+/// roughly 130 mA, against well below 1 mA for the ht3216C with LED_OFF and SYS_DIS.
+/// When the pins of the buttons are given with wake_on(), the cpu of the arduino due sleeps as well until a button changes.
+/// Without them the arduino keeps running and polls the buttons.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+/// idle_scheduler idle(chip, 60000, 100, button1, button2);
+/// idle.wake_on(hwlib::target::pins::d12);
+/// idle.wake_on(hwlib::target::pins::d13);
+///~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// @see ht3216C::shutdown_leds() ht3216C::shutdown() ht3216C::wake()
+class idle_scheduler{
+protected:
+    ht3216C & matrix;
+    std::array< hwlib::pin_in *, 4> buttons;
+    uint_fast64_t timeout_us;
+    int_fast32_t poll_ms;
+    uint_fast64_t last_activity;
+    uint8_t last_state;
+    std::array< Pio *, 4> wake_ports;
+    std::array< uint32_t, 4> wake_masks;
+    uint8_t wake_pins = 0;
+    /// \brief
+    /// this function reads all the buttons.
+    /// @returns a bitmask with one bit per button.
+    uint8_t read_buttons();
+public:
+    /// \brief
+    /// this constructor sets up the idle scheduler.
+    /// @param matrix is the ht3216C that is turned off.
+    /// @param timeout_ms is the time in ms without input before the ht3216C is turned off.
+    /// @param poll_ms is the time in ms between two button checks while the ht3216C is off, only used without wake pins.
+    /// @param b0 b1 b2 b3 are the buttons that wake the ht3216C.
+    idle_scheduler(ht3216C & matrix, uint_fast64_t timeout_ms, int_fast32_t poll_ms, hwlib::pin_in & b0, hwlib::pin_in & b1 = hwlib::pin_in_dummy, hwlib::pin_in & b2 = hwlib::pin_in_dummy, hwlib::pin_in & b3 = hwlib::pin_in_dummy);
+    /// \brief
+    /// this function adds a pin that wakes the cpu.
+    /// \details
+    /// Give the pins of all buttons, a button that is not given doesn't wake the cpu while it sleeps.
+    /// @param pin is the arduino due pin of a button.
+    /// @note at most 4 pins, more are ignored.
+    void wake_on(hwlib::target::pins pin);
+    /// \brief
+    /// this function checks the buttons and turns the ht3216C off when there was no input for too long.
+    /// \details
+    /// Call this function once every loop.
+    /// @returns true when the ht3216C has been off during this call.
+    bool update();
+    /// \brief
+    /// this function turns the ht3216C off until a button changes.
+    /// \details
+    /// The leds are turned off with LED_OFF and the clock is stopped with SYS_DIS, in one command_batch.
+    /// With wake pins, the input change interrupts of these pins are enabled and the cpu sleeps with WFE until one changes.
+    /// The interrupts stay disabled in the NVIC, SEVONPEND turns the pending interrupt into the event that ends the WFE.
+    /// So no interrupt handler runs, and nothing else in the program has to know about the sleep.
+    /// Without wake pins the arduino busy waits and checks the buttons every poll_ms.
+    /// Nothing is written to the ht3216C while it is off.
+    /// @note hwlib::now_us() is read from the SysTick counter, which wraps without being counted while the cpu sleeps.
+    /// The time asleep is not counted, and timeouts in the program continue after the wake.
+    /// @see command_batch ht3216C::wake() wake_on()
+    void turn_off();
+};
+
+#endif //IDLE_H
@@ -0,0 +1,122 @@
+#include "lockstep.hpp"
+
+void link_pin::set(bool v){
+    value = v;
+}
+bool link_pin::read(){
+    return value;
+}
+void link_pin::refresh(){}
+
+void lockstep::send(uint8_t buttons){
+    if(frame == sent && sent < acked + history){
+        local[frame % history] = buttons & link_protocol::button_mask;
+        sent++;
+    }
+    if(sent > 0){
+        uint32_t last = acked + link_protocol::frames_per_packet - 1;
+        transmit((last < sent - 1) ? last : sent - 1);
+    }
+}
+void lockstep::transmit(uint32_t f){
+    uint8_t bytes[link_protocol::length] = {link_protocol::sync};
+    uint8_t inputs = 0;
+    for(int i = link_protocol::frames_per_packet - 1; i >= 0; i--){
+        inputs <<= link_protocol::button_bits;
+        if(f >= (uint32_t)i){
+            inputs |= local[(f - i) % history];
+        }
+    }
+    bytes[1] = f & 0xff;
+    bytes[2] = (f >> 8) & 0xff;
+    bytes[3] = inputs;
+    bytes[4] = confirmed & 0xff;
+    bytes[5] = (confirmed >> 8) & 0xff;
+    uint16_t check = crc16(bytes + 1, link_protocol::length - 3);
+    bytes[6] = check >> 8;
+    bytes[7] = check & 0xff;
+    for(uint8_t byte : bytes){
+        hwlib::uart_putc(byte);
+    }
+}
+uint32_t lockstep::unwrap(uint32_t near, uint8_t low, uint8_t high){
+    uint32_t f = (near & ~0xffffUL) | low | (high << 8);
+    if(f + 0x8000 < near){
+        f += 0x10000;
+    } else if(f > near + 0x8000 && f >= 0x10000){
+        f -= 0x10000;
+    }
+    return f;
+}
+void lockstep::poll(){
+    while(hwlib::uart_char_available()){
+        uint8_t byte = hwlib::uart_getc();
+        if(length == 0 && byte != link_protocol::sync){
+            continue;
+        }
+        packet[length++] = byte;
+        if(length == link_protocol::length){
+            receive();
+            length = 0;
+        }
+    }
+}
+void lockstep::receive(){
+    if(crc16(packet.data() + 1, link_protocol::length - 3) != ((packet[6] << 8) | packet[7])){
+        return;
+    }
+    uint32_t ack = unwrap(acked, packet[4], packet[5]);
+    if(ack > acked && ack <= sent){
+        acked = ack;
+    }
+    uint32_t newest = unwrap(confirmed, packet[1], packet[2]);
+    for(int i = link_protocol::frames_per_packet - 1; i >= 0; i--){
+        if(newest < (uint32_t)i || newest - i != confirmed){
+            continue;
+        }
+        uint8_t buttons = (packet[3] >> (i * link_protocol::button_bits)) & link_protocol::button_mask;
+        if(confirmed < frame && remote[confirmed % history] != buttons && rewind < 0){
+            rewind = confirmed;
+        }
+        remote[confirmed % history] = buttons;
+        confirmed++;
+    }
+}
+void lockstep::wait_ms(int_fast32_t ms){
+    uint_fast64_t end = hwlib::now_us() + ms * 1000;
+    while(hwlib::now_us() < end){
+        poll();
+    }
+}
+bool lockstep::ready(){
+    return frame < sent && frame + 1 < confirmed + history;
+}
+uint32_t lockstep::current(){
+    return frame;
+}
+bool lockstep::is_confirmed(uint32_t f){
+    return f < confirmed;
+}
+uint8_t lockstep::local_input(uint32_t f){
+    return local[f % history];
+}
+uint8_t lockstep::remote_input(uint32_t f){
+    if(f >= confirmed){
+        remote[f % history] = (confirmed > 0) ? remote[(confirmed - 1) % history] : 0;
+    }
+    return remote[f % history];
+}
+void lockstep::advance(){
+    frame++;
+}
+void lockstep::seek(uint32_t f){
+    frame = f;
+    if(rewind >= 0 && (uint32_t)rewind >= f){
+        rewind = -1;
+    }
+}
+int32_t lockstep::rollback(){
+    int32_t from = rewind;
+    rewind = -1;
+    return from;
+}
@@ -0,0 +1,140 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+#include "hwlib.hpp"
+#include "crc.hpp"
+
+/// \brief
+/// struct with the link protocol
+/// \details
+/// this struct contains the values of the packets two boards send each other over the uart, one packet every tick.
+/// A packet looks like this, all values are bytes:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~
+/// sync frame_low frame_high buttons ack_low ack_high crc_high crc_low
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~
+/// buttons contains the buttons of frame and the 3 frames before it, 2 bits per frame, frame in the lowest bits.
+/// ack is the first frame of which the sender doesn't have the buttons of the other board yet.
+/// Every packet starts at the ack of the other board, so lost packets are send again.
+/// The crc is the CRC-16-CCITT of frame_low up to ack_high.
+/// A sum of the bytes is not enough: when a byte is lost, the sync of the next packet ends up in the check,
+/// and a packet that is send again every tick gets that same chance every tick.
+/// @see lockstep crc16()
+struct link_protocol{
+    static const uint8_t sync = 0x5a;
+    static const int length = 8;
+    static const int frames_per_packet = 4;
+    static const int button_bits = 2;
+    static const uint8_t button_mask = 0x03;
+};
+
+/// \brief
+/// This class is a pin_in that is set by the program
+/// \details
+/// With this class a player can be controlled by the buttons of another board.
+/// The value is set before every tick, read() returns it.
+class link_pin : public hwlib::pin_in{
+protected:
+    bool value = false;
+public:
+    /// \brief
+    /// this function sets the value read() returns.
+    void set(bool v);
+    /// \brief
+    /// this function returns the value that is set.
+    bool read() override;
+    /// \brief
+    /// this function does nothing, the value is set by set().
+    void refresh() override;
+};
+
+/// \brief
+/// This class keeps two boards in lockstep
+/// \details
+/// Both boards run the same game. Every tick only the buttons of the local player are send, with the frame number.
+/// When the buttons of the other board for a frame have not arrived yet, the last known buttons are used.
+/// When they arrive and differ from what was used, rollback() returns the frame the game needs to go back to,
+/// the game restores its state of that frame and runs the frames again with the right buttons.
+/// The game can run at most history - 1 frames ahead of the other board, after that ready() returns false.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+/// link.send(buttons);
+/// link.wait_ms(50);
+/// int32_t from = link.rollback();
+/// if(from >= 0){
+///     uint32_t to = link.current();
+///     restore(from);
+///     link.seek(from);
+///     while(link.current() < to){ step(); }
+/// }
+/// if(link.ready()){ step(); }
+///~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// @see link_protocol link_pin
+class lockstep{
+public:
+    static const int history = 8;
+protected:
+    std::array< uint8_t, history> local;
+    std::array< uint8_t, history> remote;
+    uint32_t frame = 0;
+    uint32_t sent = 0;
+    uint32_t confirmed = 0;
+    uint32_t acked = 0;
+    int32_t rewind = -1;
+    std::array< uint8_t, link_protocol::length> packet;
+    int length = 0;
+    /// \brief
+    /// this function handles a complete packet.
+    void receive();
+    /// \brief
+    /// this function sends the packet of frame f.
+    void transmit(uint32_t f);
+    /// \brief
+    /// this function returns the frame number nearest to near that ends with the 16 bits of low and high.
+    static uint32_t unwrap(uint32_t near, uint8_t low, uint8_t high);
+public:
+    /// \brief
+    /// this function stores and sends the local buttons of the current frame.
+    /// \details
+    /// The buttons of a frame are only stored once. When the frame has been send already, after seek() or while not ready(),
+    /// the stored buttons are used. Every call sends one packet, starting at the first frame the other board misses.
+    /// @param buttons are the buttons of the local player, 2 bits.
+    void send(uint8_t buttons);
+    /// \brief
+    /// this function reads all the waiting bytes of the uart.
+    void poll();
+    /// \brief
+    /// this function waits, and reads the uart while waiting.
+    /// \details
+    /// The uart of the board only keeps one byte, so the uart needs to be read during every wait.
+    /// @param ms is the time to wait in ms.
+    void wait_ms(int_fast32_t ms);
+    /// \brief
+    /// this function returns true when the current frame can be run.
+    bool ready();
+    /// \brief
+    /// this function returns the frame that is run next.
+    uint32_t current();
+    /// \brief
+    /// this function returns true when the buttons of the other board are known up to and including frame f.
+    bool is_confirmed(uint32_t f);
+    /// \brief
+    /// this function returns the local buttons of frame f.
+    uint8_t local_input(uint32_t f);
+    /// \brief
+    /// this function returns the buttons of the other board of frame f.
+    /// \details
+    /// When these are not known yet, the last known buttons are returned and remembered,
+    /// so a wrong guess is found when the real buttons arrive.
+    uint8_t remote_input(uint32_t f);
+    /// \brief
+    /// this function moves to the next frame, call it after a frame has been run.
+    void advance();
+    /// \brief
+    /// this function goes back to frame f, to run the frames after it again.
+    /// @note the game needs to restore its state of frame f first.
+    void seek(uint32_t f);
+    /// \brief
+    /// this function returns the first frame that was run with wrong buttons.
+    /// @returns the frame, or -1 when all frames were right.
+    int32_t rollback();
+};
+
+#endif //LOCKSTEP_H
@@ -0,0 +1,70 @@
+#include "pong.hpp"
+
+void link_buttons::set(uint8_t first, uint8_t second){
+    first_hoog.set(first & 0x01);
+    first_laag.set(first & 0x02);
+    second_hoog.set(second & 0x01);
+    second_laag.set(second & 0x02);
+}
+
+link_game::link_game(lockstep & link, bool host, game & ball, player & first, player & second, link_buttons & buttons):
+        link(link),
+        host(host),
+        ball(ball),
+        first(first),
+        second(second),
+        buttons(buttons),
+        objects{&ball, &first, &second}{}
+
+void link_game::step(){
+    uint32_t frame = link.current();
+    snapshots[frame % lockstep::history] = {ball.save(), first.save(), second.save()};
+    uint8_t mine = link.local_input(frame);
+    uint8_t theirs = link.remote_input(frame);
+    buttons.set(host ? mine : theirs, host ? theirs : mine);
+    for (auto &p : objects) {
+        p->update();
+    }
+    for (auto &p : objects) {
+        for (auto &other : objects) {
+            p->interact(*other);
+        }
+    }
+    if(ball.no_points() && point_frame < 0){
+        point_frame = frame;
+    }
+    link.advance();
+}
+void link_game::restore(uint32_t frame){
+    const snapshot & s = snapshots[frame % lockstep::history];
+    ball.restore(s.ball);
+    first.restore(s.first);
+    second.restore(s.second);
+    if(point_frame >= (int32_t)frame){
+        point_frame = -1;
+    }
+    link.seek(frame);
+}
+bool link_game::tick(uint8_t own, int_fast32_t wait_ms){
+    link.send(own);
+    link.wait_ms(wait_ms);
+    int32_t from = link.rollback();
+    if (from >= 0) {
+        uint32_t to = link.current();
+        restore(from);
+        while (link.current() < to) {
+            step();
+        }
+    }
+    if (link.ready()) {
+        step();
+    }
+    if (point_frame >= 0 && link.is_confirmed(point_frame)) {
+        if (link.current() > (uint32_t)point_frame + 1) {
+            restore(point_frame + 1);
+        }
+        point_frame = -1;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,336 @@
+#ifndef PONG_H
+#define PONG_H
+#include "hwlib.hpp"
+#include "ht3216C.hpp"
+#include "drawables.hpp"
+#include "lockstep.hpp"
+
+/// \brief
+/// this class is used to draw a player
+/// \details
+/// This class is a setup to draw a player. including the update function to move.
+/// @see line
+class player : public line {
+    hwlib::pin_in & hoog;
+    hwlib::pin_in & laag;
+public:
+    /// this construcor is used to set up a player.
+    /// @warning hwlib::pin_in is used instead of pin_in_out.
+    /// note location and end are only start coordinates.
+    player(hwlib::pin_in & hoog, hwlib::pin_in & laag, hwlib::window & w, hwlib::xy location, hwlib::xy end, hwlib::xy bounce):
+            line(w, location, end, bounce),
+            hoog( hoog ),
+            laag( laag ){}
+    /// the state of a player, used to go back in time in link play.
+    struct state{
+        hwlib::xy location;
+        hwlib::xy end;
+    };
+    /// this function returns the state of the player.
+    state save(){
+        return {location, end};
+    }
+    /// this function sets the state of the player.
+    void restore(const state & s){
+        location = s.location;
+        end = s.end;
+    }
+    /// this function updates the position of the player.
+    /// @note this changes the start and end location of the line.
+    void update() override{
+        laag.refresh();
+        if(laag.read()){
+            if(!(end.x < 4 && location.x <= 0)){
+                location.x--;
+                end.x--;
+            }
+        }
+        hoog.refresh();
+        if(hoog.read()){
+            if(!(end.x > 15)){
+                location.x++;
+                end.x++;
+            }
+        }
+    }
+};
+
+/// \brief
+/// this class is used to start the game and draw a ball.
+/// \details
+/// This class is a setup to draw a ball. including the speed and interaction with other objects. also this class is used for the startscreen() and game reset.
+/// @warning if a ball needs to be redrawn the last location need to be cleared.
+/// @see ht3216C::clear() ht3216C::clear_pixel()
+class game : public drawable{
+protected:
+    static const int left = 0;
+    static const int right = 15;
+    static const int max_bounces = 4;
+    hwlib::xy speed;
+    int p1 =0;
+    int p2 = 0;
+    bool point = false;
+    std::array<drawable *, 4> obstacles = {};
+    int number_of_obstacles = 0;
+    ///\brief
+    /// this function rounds a position in 1/sweep_one of a cell to the nearest cell.
+    static int cell(int position){
+        return ((position >= 0) ? position + sweep_one / 2 : position - sweep_one / 2) / sweep_one;
+    }
+public:
+    /// this constructor is used to the ball.
+    /// @note location is only a start coordinate.
+    game(hwlib::window & w, hwlib::xy location, hwlib::xy bounce,  hwlib::xy speed):
+            drawable(w, location, hwlib::xy(1,1) ,  bounce), speed(speed){}
+    /// the state of the ball and the scores, used to go back in time in link play.
+    struct state{
+        hwlib::xy location;
+        hwlib::xy speed;
+        int p1;
+        int p2;
+        bool point;
+    };
+    /// this function returns the state of the game.
+    state save(){
+        return {location, speed, p1, p2, point};
+    }
+    /// this function sets the state of the game.
+    void restore(const state & s){
+        location = s.location;
+        speed = s.speed;
+        p1 = s.p1;
+        p2 = s.p2;
+        point = s.point;
+    }
+    /// this function is used to a ball.
+    void draw(){
+        w.write(location);
+    }
+    ///\brief
+    /// identifier.
+    ///\details
+    /// this function is used to identify a object as ball.
+    /// returns always true.
+    /// @returns true;
+    bool is_ball(){
+        return true;
+    }
+    ///\brief
+    /// this function updates the ball.
+    ///\details
+    /// this function moves the ball by speed, the speed can be more than one cell per tick.
+    /// The path of the ball is swept: at the exact time the ball hits a border or an obstacle it bounces,
+    /// and the rest of the tick it moves on in the new direction.
+    /// the x borders (nonlethal borders) changes the speed.x. an obstacle reflects the speed on the side that is hit:
+    /// the speed.x on its left or right side, the speed.y on its top or bottom. An obstacle with bounce (1,1) is passed through.
+    /// If the ball passes the y borders. a player gets a point and the game is paused and ready to restart.
+    /// @note after max_bounces bounces in one tick the ball stays at the last bounce, the rest of that tick is not moved.
+    /// @see interact() drawable::sweep()
+    void update(){
+        hwlib::xy position = location * sweep_one;
+        hwlib::xy delta = speed * sweep_one;
+        drawable * last = nullptr;
+        for(int bounces = 0; bounces < max_bounces; bounces++){
+            int time = sweep_miss;
+            int wall = 0;
+            hwlib::xy flip(1, 1);
+            drawable * hit = nullptr;
+            if(delta.x != 0){
+                wall = ((delta.x < 0) ? left : right) * sweep_one;
+                int t = (wall - position.x) * sweep_one / delta.x;
+                if(t >= 0 && t <= sweep_one){
+                    time = t;
+                    flip = hwlib::xy(-1, 1);
+                }
+            }
+            for(int i = 0; i < number_of_obstacles; i++){
+                if(obstacles[i] == last){
+                    continue;
+                }
+                if(obstacles[i]->get_bounce() == hwlib::xy(1, 1)){
+                    continue;
+                }
+                hwlib::xy face;
+                int t = obstacles[i]->sweep(size, position, delta, face);
+                if(t != sweep_miss && (time == sweep_miss || t < time)){
+                    time = t;
+                    flip = (face.x != 0) ? hwlib::xy(-1, 1) : hwlib::xy(1, -1);
+                    hit = obstacles[i];
+                }
+            }
+            if(time == sweep_miss){
+                position = position + delta;
+                break;
+            }
+            hwlib::xy travelled(delta.x * time / sweep_one, delta.y * time / sweep_one);
+            position = position + travelled;
+            if(hit == nullptr){
+                position.x = wall;
+            }
+            last = hit;
+            delta = delta - travelled;
+            delta = hwlib::xy(delta.x * flip.x, delta.y * flip.y);
+            speed = hwlib::xy(speed.x * flip.x, speed.y * flip.y);
+        }
+        // when all bounces are used the rest of delta is dropped, the ball waits at the last bounce for the next tick.
+        location = hwlib::xy(cell(position.x), cell(position.y));
+        if(!point){
+            if(location.y < 0){ p2++; point = true;}
+            else if(location.y >= 24){p1++; point = true;}
+        }
+    }
+    ///\brief
+    /// interact with objects.
+    ///\details
+    /// This function adds the object to the obstacles of the ball.
+    /// From the next update() the ball bounces on the side of the object it hits, unless the bounce of the object is (1,1).
+    /// @see update() overlaps()
+    void interact(drawable & other) {
+        if (this != &other) {
+            for(int i = 0; i < number_of_obstacles; i++){
+                if(obstacles[i] == &other){
+                    return;
+                }
+            }
+            if(number_of_obstacles < (int)obstacles.size()){
+                obstacles[number_of_obstacles++] = &other;
+            }
+        }
+    }
+    ///\brief
+    /// returns a boolean.
+    /// @returns true if a point has been scored or false if not.
+    bool no_points(){
+        return point;
+    }
+    ///\brief
+    /// resets the game.
+    /// \details
+    /// location of the ball is set to the start location.
+    /// point is set to false.
+    /// ball speed is set to its default.
+    /// @note the small wait before the restart is done by the caller, in link play the uart is read while waiting.
+    void reset_game(hwlib::xy loc){
+        location = loc;
+        point = false;
+        speed = hwlib::xy(1,1);
+    }
+    ///\brief
+    /// returns the scores.
+    /// @returns the scores in xy format.
+    hwlib::xy get_scores(){
+        return hwlib::xy(p1, p2);
+    }
+    ///\brief
+    /// sets a hardcoded screen. In this game is says "pong ! \n start"
+    ///@param chip is the ht3216C chip also used in window
+    /// @note the chip is not written when the startscreen is already shown.
+    /// @see window chip
+    void startscreen(ht3216C & chip){
+        uint16_t w[24] = {
+                0x0, 0x0,
+                0b0101111000111110,
+                0b0101001000001010,
+                0b0111011000001110,
+                0x0,
+                0b0000010000111110,
+                0b0111110000100010,
+                0b0000010000111110,
+                0x0,
+                0b0111110000111110,
+                0b0001010000000010,
+                0b0111110000111110,
+                0x0,
+                0b0111110000101110,
+                0b0011010000101010,
+                0b0101110000111110,
+                0b0,
+                0b0000010000000000,
+                0b0111110001101110,
+                0b0000010001101110, //uitroepteken en T
+                0x0,
+                0x0, 0x0
+        };
+        chip.change_window(w);
+        chip.flush();
+    }
+};
+
+/// \brief
+/// This struct contains the buttons of both players in link play
+/// \details
+/// The players are made with these pins instead of the real buttons, set() gives them the buttons of a frame.
+/// @see link_game link_pin
+struct link_buttons{
+    link_pin first_hoog;
+    link_pin first_laag;
+    link_pin second_hoog;
+    link_pin second_laag;
+    /// \brief
+    /// this function sets the pins to the buttons of both players.
+    /// @param first are the buttons of player1, 2 bits like in link_protocol.
+    /// @param second are the buttons of player2.
+    void set(uint8_t first, uint8_t second);
+};
+
+/// \brief
+/// This class runs the game of link play
+/// \details
+/// Every tick the buttons of this board are send, and the frames are run with the buttons of both boards.
+/// Before every frame the state of the ball and the players is saved, so a frame can be run again
+/// when the buttons of the other board were guessed wrong.
+/// A point only counts when the buttons of both boards are known up to the frame of the point:
+/// then the game goes back to the state right after that frame, and tick() returns true.
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+/// link_game match(link, true, bal, player1, player2, buttons);
+/// for(;;){
+///     if(match.tick(own_buttons, 50)){
+///         bal.reset_game(start_location);
+///     }
+/// }
+///~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// @see lockstep link_buttons
+class link_game{
+protected:
+    struct snapshot{
+        game::state ball;
+        player::state first;
+        player::state second;
+    };
+    lockstep & link;
+    bool host;
+    game & ball;
+    player & first;
+    player & second;
+    link_buttons & buttons;
+    std::array< drawable *, 3> objects;
+    std::array< snapshot, lockstep::history> snapshots;
+    int32_t point_frame = -1;
+    /// \brief
+    /// this function runs one frame with the buttons of both boards.
+    void step();
+    /// \brief
+    /// this function goes back to the state before a frame.
+    void restore(uint32_t frame);
+public:
+    /// \brief
+    /// this constructor sets up link play.
+    /// @param link is the lockstep between the boards.
+    /// @param host is true on the board of player1, the other board is player2.
+    /// @param ball is the game.
+    /// @param first is player1, made with the first pins of buttons.
+    /// @param second is player2, made with the second pins of buttons.
+    /// @param buttons are the pins of both players.
+    link_game(lockstep & link, bool host, game & ball, player & first, player & second, link_buttons & buttons);
+    /// \brief
+    /// this function runs one tick of link play.
+    /// \details
+    /// The buttons of this board are send, the uart is read for wait_ms, and the game goes back when a guess was wrong.
+    /// Then the next frame is run, when the other board is not too far behind.
+    /// @param own are the buttons of this board, 2 bits like in link_protocol.
+    /// @param wait_ms is the time of one tick.
+    /// @returns true when a point is confirmed, the game is at the state right after the point.
+    bool tick(uint8_t own, int_fast32_t wait_ms);
+};
+
+#endif //PONG_H
@@ -0,0 +1,87 @@
+#include "stream.hpp"
+
+frame_receiver::frame_receiver(ht3216C & matrix, uint_fast32_t baud):
+        matrix(matrix),
+        // a byte is 10 bits on the line: start, 8 data and stop.
+        idle_us((10 * 1000000 + baud - 1) / baud){}
+
+bool frame_receiver::feed(uint8_t byte){
+    if(!receiving){
+        if(byte == frame_protocol::sync){
+            receiving = true;
+            length = 0;
+            expected = frame_protocol::header_length;
+        }
+        return false;
+    }
+    packet[length++] = byte;
+    if(length == frame_protocol::header_length){
+        uint8_t count = packet[2];
+        if(count > commands::com){
+            receiving = false;
+            return false;
+        }
+        expected = frame_protocol::header_length + count * frame_protocol::row_length + frame_protocol::crc_length;
+    }
+    if(length < expected){
+        return false;
+    }
+    receiving = false;
+    return apply();
+}
+
+bool frame_receiver::apply(){
+    int rows_end = length - frame_protocol::crc_length;
+    if(crc16(packet.data(), rows_end) != ((packet[rows_end] << 8) | packet[rows_end + 1])){
+        synced = false;
+        return false;
+    }
+    uint8_t type = packet[0];
+    if(type == frame_protocol::key){
+        for(int i = 0; i < commands::com; i++){
+            frame[i] = 0x0000;
+        }
+        synced = true;
+    } else if(type != frame_protocol::delta || packet[1] != (uint8_t)(sequence + 1)){
+        synced = false;
+    }
+    if(!synced){
+        return false;
+    }
+    sequence = packet[1];
+    for(int i = frame_protocol::header_length; i < rows_end; i += frame_protocol::row_length){
+        uint8_t row = packet[i];
+        if(row < commands::com){
+            frame[row] ^= (packet[i + 1] << 8) | packet[i + 2];
+        }
+    }
+    return true;
+}
+
+bool frame_receiver::poll(){
+    while(hwlib::uart_char_available()){
+        pending |= feed(hwlib::uart_getc());
+        last_byte = hwlib::now_us();
+    }
+    if(hwlib::now_us() - last_byte < idle_us){
+        return false;
+    }
+    // the line is quiet, the rest of a half received frame is not coming anymore.
+    receiving = false;
+    if(!pending){
+        return false;
+    }
+    pending = false;
+    matrix.change_window(frame);
+    matrix.flush();
+    return true;
+}
+
+void frame_receiver::run(int_fast32_t timeout_ms){
+    uint_fast64_t last_frame = hwlib::now_us();
+    while(hwlib::now_us() - last_frame < (uint_fast64_t)timeout_ms * 1000){
+        if(poll()){
+            last_frame = hwlib::now_us();
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef STREAM_H
+#define STREAM_H
+#include "hwlib.hpp"
+#include "ht3216C.hpp"
+#include "crc.hpp"
+
+/// \brief
+/// struct with the frame protocol
+/// \details
+/// this struct contains the values of the frames a host sends over the uart.
+/// A frame looks like this, all values are bytes:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~
+/// sync type sequence count (row high low) * count crc_high crc_low
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~
+/// The rows are XORed with the rows of the frame before, only the changed rows are send.
+/// A key frame starts from an empty frame, so it contains all rows that are not empty.
+/// The crc is the CRC-16-CCITT of all bytes from type up to the last row, like the packets of link_protocol.
+/// A frame that is accepted by mistake breaks every delta frame up to the next key frame, a sum of the bytes is not enough.
+/// @see frame_receiver crc16()
+struct frame_protocol{
+    static const uint8_t sync = 0xa5;
+    static const uint8_t delta = 0x00;
+    static const uint8_t key = 0x01;
+    static const int header_length = 3;
+    static const int row_length = 3;
+    static const int crc_length = 2;
+    static const int max_length = header_length + row_length * commands::com + crc_length;
+};
+
+/// \brief
+/// This class shows frames that are send by a host over the uart
+/// \details
+/// The bytes are read from the uart and applied to a frame of 24 rows, the frame is written to the ht3216C.
+/// When more than one frame has arrived since the last flush, only the latest frame is written.
+/// The uart of the arduino due holds only one byte, so bytes that arrive while the ht3216C is written are lost.
+/// That's why a frame is only written when the line has been quiet for at least one byte time,
+/// the host has to leave a gap after every frame that is longer than a flush, see tools/frame_sender.cpp.
+/// A frame with a wrong crc or a missing sequence number is dropped, all delta frames after it are dropped until the next key frame.
+/// A frame that is still incomplete when the line has been quiet for one byte time is dropped too,
+/// so a lost byte doesn't take the next frame with it.
+/// The frames are written with ht3216C::flush(), so the background layer is shown as well. Clear it before receiving.
+/// @see frame_protocol
+class frame_receiver{
+protected:
+    ht3216C & matrix;
+    uint16_t frame[24] = {0};
+    std::array< uint8_t, frame_protocol::max_length> packet;
+    int length = 0;
+    int expected = 0;
+    bool receiving = false;
+    bool synced = false;
+    bool pending = false;
+    uint8_t sequence = 0;
+    uint_fast32_t idle_us;
+    uint_fast64_t last_byte = 0;
+    /// \brief
+    /// this function applies a complete packet to the frame.
+    /// @returns true when the frame has changed.
+    bool apply();
+public:
+    /// \brief
+    /// this constructor sets up the receiver.
+    /// @param matrix is the ht3216C the frames are written to.
+    /// @param baud is the baud rate of the uart, a frame is written after one byte time without bytes.
+    frame_receiver(ht3216C & matrix, uint_fast32_t baud = 115200);
+    /// \brief
+    /// this function handles one received byte.
+    /// @returns true when this byte completed a valid frame.
+    bool feed(uint8_t byte);
+    /// \brief
+    /// this function reads all the waiting bytes of the uart and writes the latest frame.
+    /// \details
+    /// The ht3216C is only written once, after all waiting bytes are handled and the line has been quiet for one byte time.
+    /// Until then a received frame stays pending, a newer frame replaces it. A half received frame is dropped at that time.
+    /// @returns true when a frame has been written.
+    bool poll();
+    /// \brief
+    /// this function shows frames until the host stops sending.
+    /// @param timeout_ms is the time without a new frame after which this function returns.
+    void run(int_fast32_t timeout_ms);
+};
+
+#endif //STREAM_H
@@ -0,0 +1,41 @@
+#include "text.hpp"
+
+void font::print(ht3216C & matrix, hwlib::xy position, const char * text){
+    int row = position.y;
+    for(const char * c = text; *c != '\0' && row < commands::com; c++){
+        for(int i = 0; i < width; i++){
+            if(row >= 0){
+                matrix.write_row(row, (uint16_t)column(*c, i) << position.x);
+            }
+            row++;
+        }
+        row++;
+    }
+}
+
+marquee::marquee(ht3216C & matrix, const char * text, uint8_t lane):
+        matrix(matrix),
+        text(text),
+        next(text),
+        lane(lane){}
+void marquee::step(){
+    if(*next == '\0'){
+        // an empty text only scrolls in empty rows.
+        matrix.scroll(0, font::mask << lane);
+        return;
+    }
+    uint8_t bits = font::column(*next, column);
+    column++;
+    if(column > font::width){
+        column = 0;
+        next++;
+        if(*next == '\0'){
+            next = text;
+        }
+    }
+    matrix.scroll((uint16_t)bits << lane, font::mask << lane);
+}
+void marquee::restart(){
+    next = text;
+    column = 0;
+}
@@ -0,0 +1,137 @@
+#ifndef TEXT_H
+#define TEXT_H
+#include "hwlib.hpp"
+#include "ht3216C.hpp"
+
+/// \brief
+/// This class contains a small font for the ht3216C
+/// \details
+/// Every glyph is 3 columns wide and 5 pixels high. A column is a bitmask, bit 0 is the top pixel.
+/// The text is read along the rows (coms) of the ht3216C, like the startscreen, so one column of a glyph is part of one row.
+/// The font has a space, '!', '-', ':', the digits and the capitals. Small letters are printed as capitals, unknown characters as a space.
+class font{
+public:
+    static const int width = 3;
+    static const int height = 5;
+    static const uint16_t mask = 0x1f;
+    static const char first = ' ';
+    static const char last = 'Z';
+    /// \brief
+    /// the glyph table, one glyph for every character from first to last.
+    static constexpr uint8_t glyphs[last - first + 1][width] = {
+        {0x00, 0x00, 0x00}, // ' '
+        {0x00, 0x17, 0x00}, // '!'
+        {0x00, 0x00, 0x00}, // '"'
+        {0x00, 0x00, 0x00}, // '#'
+        {0x00, 0x00, 0x00}, // '$'
+        {0x00, 0x00, 0x00}, // '%'
+        {0x00, 0x00, 0x00}, // '&'
+        {0x00, 0x00, 0x00}, // '''
+        {0x00, 0x00, 0x00}, // '('
+        {0x00, 0x00, 0x00}, // ')'
+        {0x00, 0x00, 0x00}, // '*'
+        {0x00, 0x00, 0x00}, // '+'
+        {0x00, 0x00, 0x00}, // ','
+        {0x04, 0x04, 0x04}, // '-'
+        {0x00, 0x00, 0x00}, // '.'
+        {0x00, 0x00, 0x00}, // '/'
+        {0x1f, 0x11, 0x1f}, // '0'
+        {0x12, 0x1f, 0x10}, // '1'
+        {0x1d, 0x15, 0x17}, // '2'
+        {0x11, 0x15, 0x1f}, // '3'
+        {0x07, 0x04, 0x1f}, // '4'
+        {0x17, 0x15, 0x1d}, // '5'
+        {0x1f, 0x15, 0x1d}, // '6'
+        {0x01, 0x1d, 0x03}, // '7'
+        {0x1f, 0x15, 0x1f}, // '8'
+        {0x17, 0x15, 0x1f}, // '9'
+        {0x00, 0x0a, 0x00}, // ':'
+        {0x00, 0x00, 0x00}, // ';'
+        {0x00, 0x00, 0x00}, // '<'
+        {0x00, 0x00, 0x00}, // '='
+        {0x00, 0x00, 0x00}, // '>'
+        {0x00, 0x00, 0x00}, // '?'
+        {0x00, 0x00, 0x00}, // '@'
+        {0x1e, 0x05, 0x1e}, // 'A'
+        {0x1f, 0x15, 0x0a}, // 'B'
+        {0x0e, 0x11, 0x11}, // 'C'
+        {0x1f, 0x11, 0x0e}, // 'D'
+        {0x1f, 0x15, 0x11}, // 'E'
+        {0x1f, 0x05, 0x01}, // 'F'
+        {0x0e, 0x11, 0x1d}, // 'G'
+        {0x1f, 0x04, 0x1f}, // 'H'
+        {0x11, 0x1f, 0x11}, // 'I'
+        {0x08, 0x10, 0x0f}, // 'J'
+        {0x1f, 0x04, 0x1b}, // 'K'
+        {0x1f, 0x10, 0x10}, // 'L'
+        {0x1f, 0x06, 0x1f}, // 'M'
+        {0x1f, 0x01, 0x1e}, // 'N'
+        {0x0e, 0x11, 0x0e}, // 'O'
+        {0x1f, 0x05, 0x02}, // 'P'
+        {0x0e, 0x19, 0x16}, // 'Q'
+        {0x1f, 0x05, 0x1a}, // 'R'
+        {0x12, 0x15, 0x09}, // 'S'
+        {0x01, 0x1f, 0x01}, // 'T'
+        {0x1f, 0x10, 0x1f}, // 'U'
+        {0x0f, 0x10, 0x0f}, // 'V'
+        {0x1f, 0x0c, 0x1f}, // 'W'
+        {0x1b, 0x04, 0x1b}, // 'X'
+        {0x03, 0x1c, 0x03}, // 'Y'
+        {0x19, 0x15, 0x13}, // 'Z'
+    };
+    /// \brief
+    /// this function returns a column of a glyph.
+    /// @param c is the character.
+    /// @param i is the column, between 0 and width.
+    /// @returns the bitmask of the column, bit 0 is the top pixel.
+    static constexpr uint8_t column(char c, int i){
+        if(c >= 'a' && c <= 'z'){
+            c = c - 'a' + 'A';
+        }
+        return (c < first || c > last || i < 0 || i >= width) ? 0 : glyphs[c - first][i];
+    }
+    /// \brief
+    /// this function prints a text on the selected layer of the ht3216C.
+    /// \details
+    /// Every column of a glyph is ORed into one row at once, there is one empty row between two glyphs.
+    /// Characters that don't fit on the matrix are not printed.
+    /// @param matrix is the ht3216C.
+    /// @param position x is the top pixel of the glyphs, y is the row of the first column.
+    /// @param text is the text to print, ended by a '\0'.
+    /// @see ht3216C::write_row() ht3216C::select_layer()
+    static void print(ht3216C & matrix, hwlib::xy position, const char * text);
+};
+
+/// \brief
+/// This class scrolls a text over the ht3216C
+/// \details
+/// Every step all rows of the lane move one row up in the background layer of the ht3216C,
+/// and the next column of the text is added in the last row.
+/// Only 24 row words are moved every step, the text is never drawn pixel by pixel.
+/// When the end of the text is reached it starts again. An empty text scrolls in empty rows.
+/// @see ht3216C::scroll() font
+class marquee{
+protected:
+    ht3216C & matrix;
+    const char * text;
+    const char * next;
+    uint8_t lane;
+    uint8_t column = 0;
+public:
+    /// \brief
+    /// this constructor sets up the marquee.
+    /// @param matrix is the ht3216C.
+    /// @param text is the text to scroll, ended by a '\0'. It is not copied.
+    /// @param lane is the top pixel of the glyphs, the lane is 5 pixels high.
+    marquee(ht3216C & matrix, const char * text, uint8_t lane);
+    /// \brief
+    /// this function scrolls the text by one row.
+    /// @note Set up function, the ht3216C is written by the next flush.
+    void step();
+    /// \brief
+    /// this function starts the text again from its first column.
+    /// @note the rows that are already in the lane stay, they scroll out with the next steps.
+    void restart();
+};
+
+#endif //TEXT_H
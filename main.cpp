@@ -2,161 +2,27 @@
 #include "hwlib.hpp"
 #include "lib_ht3216C/ht3216C.hpp."
 #include "lib_ht3216C/drawables.hpp"
+#include "lib_ht3216C/idle.hpp"
+#include "lib_ht3216C/text.hpp"
+#include "lib_ht3216C/stream.hpp"
+#include "lib_ht3216C/effects.hpp"
+#include "lib_ht3216C/lockstep.hpp"
+#include "lib_ht3216C/pong.hpp"
 
 /// \brief
-/// this class is used to draw a player
-/// \details
-/// This class is a setup to draw a player. including the update function to move.
-/// @see line
-class player : public line {
-    hwlib::pin_in & hoog;
-    hwlib::pin_in & laag;
-public:
-    /// this construcor is used to set up a player.
-    /// @warning hwlib::pin_in is used instead of pin_in_out.
-    /// note location and end are only start coordinates.
-    player(hwlib::pin_in & hoog, hwlib::pin_in & laag, hwlib::window & w, hwlib::xy location, hwlib::xy end, hwlib::xy bounce):
-            line(w, location, end, bounce),
-            hoog( hoog ),
-            laag( laag ){}
-    /// this function updates the position of the player.
-    /// @note this changes the start and end location of the line.
-    void update() override{
-        laag.refresh();
-        if(laag.read()){
-            if(!(end.x < 4 && location.x <= 0)){
-                location.x--;
-                end.x--;
-            }
-        }
-        hoog.refresh();
-        if(hoog.read()){
-            if(!(end.x > 15)){
-                location.x++;
-                end.x++;
-            }
-        }
-    }
-};
-
-/// \brief
-/// this class is used to start the game and draw a ball.
-/// \details
-/// This class is a setup to draw a ball. including the speed and interaction with other objects. also this class is used for the startscreen() and game reset.
-/// @warning if a ball needs to be redrawn the last location need to be cleared.
-/// @see ht3216C::clear() ht3216C::clear_pixel()
-class game : public drawable{
-protected:
-    hwlib::xy speed;
-    int p1 =0;
-    int p2 = 0;
-    bool point = false;
-public:
-    /// this constructor is used to the ball.
-    /// @note location is only a start coordinate.
-    game(hwlib::window & w, hwlib::xy location, hwlib::xy bounce,  hwlib::xy speed):
-            drawable(w, location, hwlib::xy(1,1) ,  bounce), speed(speed){}
-    /// this function is used to a ball.
-    void draw(){
-        w.write(location);
-    }
-    ///\brief
-    /// identifier.
-    ///\details
-    /// this function is used to identify a object as ball.
-    /// returns always true.
-    /// @returns true;
-    bool is_ball(){
-        return true;
-    }
-    ///\brief
-    /// this function updates the ball.
-    ///\details
-    /// this function updates the ball by adding speed to the location.
-    /// It also check if the ball hits a border. the x borders (nonlethal borders) changes the speed.x.
-    /// If a collision with the y borders. a player gets a point and the game is paused and ready to restart.
-    void update(){
-            if(location.x == 0 || location.x >= 15){
-                speed.x *= -1;
-            }
-            else if(location.y < 0){ p2++; point = true;}
-            else if(location.y >= 24){p1++; point = true;}
-            location = location + speed;
-    }
-    ///\brief
-    /// interact with objects.
-    ///\details
-    /// This function changes the speed if a collision happens with an object.
-    /// @see overlaps()
-    void interact(drawable & other) {
-        if (this != &other) {
-            if (overlaps(other)) {
-                hwlib::xy bounce = other.get_bounce();
-                speed.x *= bounce.x;
-                speed.y *= bounce.y;
-            }
-        }
-    }
-    ///\brief
-    /// returns a boolean.
-    /// @returns true if a point has been scored or false if not.
-    bool no_points(){
-        return point;
+/// this function writes a score as text.
+/// @param score is the score, between 0 and 99.
+/// @param text needs room for 3 characters.
+void score_text(int score, char * text){
+    if(score > 99){
+        score = 99;
     }
-    ///\brief
-    /// resets the game.
-    /// \details
-    /// location of the ball is set to the start location.
-    /// point is set to false.
-    /// ball speed is set to its default.
-    /// a small wait is activated
-    void reset_game(hwlib::xy loc){
-        location = loc;
-        point = false;
-        speed = hwlib::xy(1,1);
-        hwlib::wait_ms(500);
+    if(score >= 10){
+        *text++ = '0' + score / 10;
     }
-    ///\brief
-    /// returns the scores.
-    /// @returns the scores in xy format.
-    hwlib::xy get_scores(){
-        return hwlib::xy(p1, p2);
-    }
-    ///\brief
-    /// sets a hardcoded screen. In this game is says "pong ! \n start"
-    ///@param chip is the ht3216C chip also used in window
-    /// @see window chip
-    void startscreen(ht3216C chip){
-        uint16_t w[24] = {
-                0x0, 0x0,
-                0b0101111000111110,
-                0b0101001000001010,
-                0b0111011000001110,
-                0x0,
-                0b0000010000111110,
-                0b0111110000100010,
-                0b0000010000111110,
-                0x0,
-                0b0111110000111110,
-                0b0001010000000010,
-                0b0111110000111110,
-                0x0,
-                0b0111110000101110,
-                0b0011010000101010,
-                0b0101110000111110,
-                0b0,
-                0b0000010000000000,
-                0b0111110001101110,
-                0b0000010001101110, //uitroepteken en T
-                0x0,
-                0x0, 0x0
-        };
-        chip.change_window(w);
-        chip.flush();
-    }
-};
-
-
+    *text++ = '0' + score % 10;
+    *text = '\0';
+}
 
 int main(void){
     // kill the watchdog
@@ -183,22 +49,89 @@ int main(void){
     ht3216C chip(write, data, cs);
     window w(hwlib::xy(16, 24), chip);
     //============================================================
+    // option calibrate the write strobe, to write as fast as the ht3216C allows.
+    // only turn this on after tools/trace_check passes on a capture of a flush() of this board.
+    //chip.calibrate();
+    //============================================================
+    // link play: two boards with a panel each play one match over the uart.
+    // each board has the buttons of one player on d12 and d13, only these buttons are send every tick.
+    // set link_play on both boards and link_host on one of them, the host is player1.
+    const bool link_play = false;
+    const bool link_host = true;
+    lockstep link;
+    link_buttons remote;
+    hwlib::pin_in & hoog1 = link_play ? static_cast<hwlib::pin_in &>(remote.first_hoog) : player1_hoog;
+    hwlib::pin_in & laag1 = link_play ? static_cast<hwlib::pin_in &>(remote.first_laag) : player1_laag;
+    hwlib::pin_in & hoog2 = link_play ? static_cast<hwlib::pin_in &>(remote.second_hoog) : player2_hoog;
+    hwlib::pin_in & laag2 = link_play ? static_cast<hwlib::pin_in &>(remote.second_laag) : player2_laag;
+    //============================================================
     // pong objects initialization like player and ball.
-    player player1(player1_hoog, player1_laag, w,  hwlib::xy(6,0), hwlib::xy(10,0), hwlib::xy(1,-1));
-    player player2(player2_hoog, player2_laag, w,  hwlib::xy(6,23), hwlib::xy(10,23), hwlib::xy(1,-1));
+    player player1(hoog1, laag1, w,  hwlib::xy(6,0), hwlib::xy(10,0), hwlib::xy(1,-1));
+    player player2(hoog2, laag2, w,  hwlib::xy(6,23), hwlib::xy(10,23), hwlib::xy(1,-1));
     hwlib::xy start_location = {12, 8};
     game bal(w, start_location, hwlib::xy(1,1), hwlib::xy(1,1));
     std::array<drawable *, 3>objects = {&bal, &player1, &player2};
     //============================================================
+    // link play: runs the frames with the buttons of both boards, and goes back when a guess was wrong.
+    link_game match(link, link_host, bal, player1, player2, remote);
+    //============================================================
+    // turn the ledmatrix off after a minute without input.
+    // the cpu sleeps too until one of the buttons changes.
+    idle_scheduler idle(chip, 60000, 100, player1_hoog, player1_laag, player2_hoog, player2_laag);
+    idle.wake_on(target::pins::d12);
+    idle.wake_on(target::pins::d13);
+    idle.wake_on(target::pins::d7);
+    idle.wake_on(target::pins::d6);
+    //============================================================
+    // frames send by a host over the uart, see tools/frame_sender.cpp.
+    frame_receiver receiver(chip);
+    //============================================================
+    // brightness and blink effects, done by the ht3216C itself.
+    effects flash(chip);
+    //============================================================
     // option testfunction();
     //w.test_function();
     //============================================================
     // set startscreen and wait for all players to be ready.
     // all buttons need to be pressed to start game.
-    while((player1_laag.read() || player1_hoog.read() || player2_hoog.read() || player2_laag.read())){
-        bal.startscreen(chip);
-        hwlib::wait_ms(250);
+    // when a host starts sending frames, these are shown until the host stops.
+    // the startscreen pulses slowly, every few seconds a hint scrolls by in the middle lane.
+    // the hint ends with 6 spaces, so after one pass the lane is empty again.
+    // in link play only the buttons of this board are used, the boards wait for each other in the first frames.
+    const int start_ticks = 80;
+    static const char hint_text[] = "PRESS ALL BUTTONS      ";
+    const int hint_ticks = (sizeof(hint_text) - 1) * (font::width + 1);
+    marquee hint(chip, hint_text, 5);
+    int start_tick = 0;
+    flash.pulse(4, 15, 80);
+    while(link_play ? (player1_laag.read() || player1_hoog.read()) : (player1_laag.read() || player1_hoog.read() || player2_hoog.read() || player2_laag.read())){
+        if(!link_play && hwlib::uart_char_available()){
+            // the frames of the host are shown without the hint, the hint starts again afterwards.
+            chip.clear_background();
+            receiver.run(2000);
+            hint.restart();
+            start_tick = 0;
+        }
+        if(start_tick < start_ticks){
+            bal.startscreen(chip);
+        }else{
+            hint.step();
+            chip.flush();
+        }
+        start_tick = (start_tick + 1) % (start_ticks + hint_ticks);
+        hwlib::wait_ms(50);
+        idle.update();
+        flash.update();
     }
+    flash.stop();
+    chip.clear_background();
+    //============================================================
+    // draw the static center line once on the background layer.
+    w.select_layer(layer::background);
+    for(int x = 0; x < 16; x += 2){
+        w.write(hwlib::xy(x, 11));
+    }
+    w.select_layer(layer::dynamic);
     //============================================================
     // game loop.
     for(;;) {
@@ -206,15 +139,31 @@ int main(void){
         // start game
         for (;;) {
             //============================================================
-            // clear window and redraw objects.
+            // clear window and redraw the moving objects, the background layer is kept.
             w.clear();
             for (auto &p : objects) {
                 p->draw();
             }
             w.flush();
             //============================================================
+            // link play: send the buttons of this board, go back when a guess of the other buttons was wrong,
+            // and run the next frame when the other board is not too far behind.
+            // a point only counts when the buttons of both boards are known up to that frame.
+            if (link_play) {
+                player1_hoog.refresh();
+                player1_laag.refresh();
+                bool scored = match.tick((player1_hoog.read() ? 0x01 : 0x00) | (player1_laag.read() ? 0x02 : 0x00), 50);
+                flash.update();
+                if (scored) {
+                    break;
+                }
+                continue;
+            }
+            //============================================================
             // gameloop speed.
             hwlib::wait_ms(50);
+            idle.update();
+            flash.update();
             //============================================================
             // update objects.
             for (auto &p : objects) {
@@ -234,9 +183,31 @@ int main(void){
             }
         }
         //============================================================
-        // reset game, draw scores on terminal.
+        // reset game, draw scores on terminal and on the matrix, each score on the half of its player.
+        // the scores stay on the matrix for 3 seconds, the first second the matrix blinks.
+        // the effects are updated every tick of the pause.
         hwlib::xy scores = bal.get_scores();
-        hwlib::cout << "player1: " << scores.x << " player2: " << scores.y << "\n";
+        if (!link_play) {
+            hwlib::cout << "player1: " << scores.x << " player2: " << scores.y << "\n";
+        }
+        char score[3];
+        score_text(scores.x, score);
+        font::print(chip, hwlib::xy(5, 3), score);
+        score_text(scores.y, score);
+        font::print(chip, hwlib::xy(5, 15), score);
+        chip.flush();
+        const int score_ticks = 60;
+        const int blink_ticks = 20;
+        flash.blink(blink_ticks);
+        for (int tick = 0; tick < score_ticks; tick++) {
+            if (link_play) {
+                link.wait_ms(50);
+            } else {
+                hwlib::wait_ms(50);
+            }
+            flash.update();
+        }
+        flash.stop();
         bal.reset_game(start_location);
     }
 }
\ No newline at end of file
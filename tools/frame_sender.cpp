@@ -0,0 +1,150 @@
+// Frame sender for the uart receive mode of the ht3216C, see frame_receiver in lib_ht3216C/stream.hpp.
+//
+// This is a host program, it is not part of the firmware build:
+//     g++ -std=c++17 -O2 -Ilib_ht3216C -o frame_sender tools/frame_sender.cpp lib_ht3216C/crc.cpp
+//     ./frame_sender /dev/ttyACM0 115200 [fps] < frames.bin
+//
+// The input is a stream of raw frames of 48 bytes: 24 rows of 16 bits, high byte first.
+// Only the rows that changed are send, XORed with the row of the frame before.
+// Every key_interval frames a key frame is send, so the panel recovers from a lost frame.
+// Without fps the frames are send as fast as the baud rate allows.
+// After every frame the line stays quiet for frame_gap_us: the panel only writes a frame when the line is quiet,
+// and the uart of the arduino due loses the bytes that arrive while the panel is written.
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "crc.hpp"
+
+static const uint8_t sync_byte = 0xa5;
+static const uint8_t delta_frame = 0x00;
+static const uint8_t key_frame = 0x01;
+static const int rows = 24;
+static const int key_interval = 50;
+// longer than a full flush of the ht3216C with the default timing, plus one byte time.
+static const long frame_gap_us = 2000;
+
+static speed_t baud_constant(long baud){
+    switch(baud){
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        default: return 0;
+    }
+}
+
+static int open_port(const char * path, speed_t speed){
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if(fd < 0){
+        return -1;
+    }
+    termios tty{};
+    if(tcgetattr(fd, &tty) == 0){
+        cfmakeraw(&tty);
+        cfsetispeed(&tty, speed);
+        cfsetospeed(&tty, speed);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+    return fd;
+}
+
+static std::vector<uint8_t> encode(const uint16_t * frame, const uint16_t * before, uint8_t sequence, bool key){
+    std::vector<uint8_t> packet = {sync_byte, key ? key_frame : delta_frame, sequence, 0};
+    for(int row = 0; row < rows; row++){
+        uint16_t change = key ? frame[row] : (frame[row] ^ before[row]);
+        if(change){
+            packet.push_back(row);
+            packet.push_back(change >> 8);
+            packet.push_back(change & 0xff);
+            packet[3]++;
+        }
+    }
+    uint16_t check = crc16(packet.data() + 1, packet.size() - 1);
+    packet.push_back(check >> 8);
+    packet.push_back(check & 0xff);
+    return packet;
+}
+
+static bool send_all(int fd, const std::vector<uint8_t> & packet){
+    size_t done = 0;
+    while(done < packet.size()){
+        ssize_t n = write(fd, packet.data() + done, packet.size() - done);
+        if(n < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+int main(int argc, char ** argv){
+    if(argc < 3 || argc > 4){
+        std::fprintf(stderr, "usage: %s port baud [fps] < frames.bin\n", argv[0]);
+        return 2;
+    }
+    long baud = std::atol(argv[2]);
+    speed_t speed = baud_constant(baud);
+    if(!speed){
+        std::fprintf(stderr, "unsupported baud rate %ld\n", baud);
+        return 2;
+    }
+    int fd = open_port(argv[1], speed);
+    if(fd < 0){
+        std::fprintf(stderr, "can't open %s: %s\n", argv[1], std::strerror(errno));
+        return 2;
+    }
+    double fps = (argc == 4) ? std::atof(argv[3]) : 0;
+
+    uint16_t frame[rows] = {0};
+    uint16_t before[rows] = {0};
+    uint8_t raw[rows * 2];
+    uint8_t sequence = 0;
+    long frames = 0;
+    long bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    while(std::fread(raw, sizeof(raw), 1, stdin) == 1){
+        for(int row = 0; row < rows; row++){
+            frame[row] = (raw[row * 2] << 8) | raw[row * 2 + 1];
+        }
+        auto sent = std::chrono::steady_clock::now();
+        bool key = (frames % key_interval) == 0;
+        sequence = key ? 0 : sequence + 1;
+        std::vector<uint8_t> packet = encode(frame, before, sequence, key);
+        if(!send_all(fd, packet)){
+            std::fprintf(stderr, "write failed: %s\n", std::strerror(errno));
+            return 1;
+        }
+        std::memcpy(before, frame, sizeof(frame));
+        frames++;
+        bytes += packet.size();
+        // tcdrain() waits for the wire on a real port, the sleep also keeps the gap on a pty.
+        tcdrain(fd);
+        auto quiet = sent + std::chrono::microseconds((long)(packet.size() * 10 * 1000000 / baud) + frame_gap_us);
+        if(fps > 0){
+            next += std::chrono::microseconds((long)(1e6 / fps));
+        }
+        std::this_thread::sleep_until((fps > 0 && next > quiet) ? next : quiet);
+    }
+    tcdrain(fd);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%ld frames, %ld bytes, %.1f frames per second, %.1f bytes per frame\n",
+                 frames, bytes, seconds > 0 ? frames / seconds : 0.0, frames ? double(bytes) / frames : 0.0);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Host stand-in for the part of hwlib that lib_ht3216C uses.
+//
+// This file is only used by the host programs in tools/, the firmware is build against the real hwlib.
+// The types behave like the hwlib ones, the platform functions are only declared:
+// every host program defines them itself, so it can decide what the uart and the clock are.
+//     g++ -std=c++17 -Itools/host -Ilib_ht3216C ...
+
+#ifndef HWLIB_HOST_H
+#define HWLIB_HOST_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace hwlib {
+
+struct xy {
+    int_fast16_t x, y;
+    constexpr xy(int_fast16_t x = 0, int_fast16_t y = 0): x(x), y(y){}
+    constexpr xy operator+(xy other) const { return xy(x + other.x, y + other.y); }
+    constexpr xy operator-(xy other) const { return xy(x - other.x, y - other.y); }
+    constexpr xy operator*(int n) const { return xy(x * n, y * n); }
+    constexpr xy operator/(int n) const { return xy(x / n, y / n); }
+    constexpr bool operator==(xy other) const { return x == other.x && y == other.y; }
+    constexpr bool operator!=(xy other) const { return !(*this == other); }
+};
+
+struct color {
+    uint8_t red, green, blue;
+    constexpr color(uint8_t red = 0, uint8_t green = 0, uint8_t blue = 0): red(red), green(green), blue(blue){}
+    constexpr bool operator==(color other) const { return red == other.red && green == other.green && blue == other.blue; }
+    constexpr bool operator!=(color other) const { return !(*this == other); }
+};
+constexpr color black(0, 0, 0);
+constexpr color white(255, 255, 255);
+
+struct pin_in {
+    virtual bool read() = 0;
+    virtual void refresh(){}
+    virtual ~pin_in(){}
+};
+
+struct pin_in_out {
+    virtual void direction_set_input(){}
+    virtual void direction_set_output(){}
+    virtual void direction_flush(){}
+    virtual bool read(){ return false; }
+    virtual void write(bool){}
+    virtual void refresh(){}
+    virtual void flush(){}
+    virtual ~pin_in_out(){}
+};
+
+struct pin_in_dummy_class : pin_in {
+    bool read() override { return false; }
+};
+struct pin_in_out_dummy_class : pin_in_out {};
+inline pin_in_dummy_class pin_in_dummy;
+inline pin_in_out_dummy_class pin_in_out_dummy;
+
+class window {
+public:
+    xy size;
+    color foreground, background;
+    window(xy size, color foreground = white, color background = black):
+            size(size), foreground(foreground), background(background){}
+    virtual ~window(){}
+    void write(xy pos, color col){
+        if(pos.x >= 0 && pos.y >= 0 && pos.x < size.x && pos.y < size.y){
+            write_implementation(pos, col);
+        }
+    }
+    void write(xy pos){ write(pos, foreground); }
+    virtual void clear(){
+        for(int_fast16_t y = 0; y < size.y; y++){
+            for(int_fast16_t x = 0; x < size.x; x++){
+                write(xy(x, y), background);
+            }
+        }
+    }
+    virtual void flush(){}
+protected:
+    virtual void write_implementation(xy pos, color col) = 0;
+};
+
+// Bresenham, like hwlib::line.
+class line {
+    xy start, end;
+public:
+    line(xy start, xy end): start(start), end(end){}
+    void draw(window & w){
+        int x0 = start.x, y0 = start.y, x1 = end.x, y1 = end.y;
+        int dx = std::abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+        int dy = -std::abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+        int error = dx + dy;
+        for(;;){
+            w.write(xy(x0, y0));
+            if(x0 == x1 && y0 == y1){
+                return;
+            }
+            int e2 = 2 * error;
+            if(e2 >= dy){ error += dy; x0 += sx; }
+            if(e2 <= dx){ error += dx; y0 += sy; }
+        }
+    }
+};
+
+// Midpoint circle, like hwlib::circle.
+class circle {
+    xy center;
+    int radius;
+public:
+    circle(xy center, int radius): center(center), radius(radius){}
+    void draw(window & w){
+        int x = radius, y = 0, error = 1 - radius;
+        while(x >= y){
+            const xy points[8] = {xy(x, y), xy(y, x), xy(-y, x), xy(-x, y), xy(-x, -y), xy(-y, -x), xy(y, -x), xy(x, -y)};
+            for(const auto & p : points){
+                w.write(center + p);
+            }
+            y++;
+            if(error < 0){
+                error += 2 * y + 1;
+            } else {
+                x--;
+                error += 2 * (y - x) + 1;
+            }
+        }
+    }
+};
+
+struct ostream {
+    template<typename T>
+    ostream & operator<<(const T &){ return *this; }
+};
+inline ostream cout;
+
+// defined by the host program.
+void wait_ns(int_fast32_t ns);
+void wait_us(int_fast32_t us);
+void wait_ms(int_fast32_t ms);
+uint_fast64_t now_us();
+bool uart_char_available();
+char uart_getc();
+void uart_putc(char c);
+
+} // namespace hwlib
+
+#endif // HWLIB_HOST_H
@@ -0,0 +1,328 @@
+// Link test for link play, see link_game in lib_ht3216C/pong.hpp and lockstep in lib_ht3216C/lockstep.hpp.
+//
+// This is a host program, it is not part of the firmware build:
+//     g++ -std=c++17 -O2 -Itools/host -Ilib_ht3216C -o lockstep_link tools/lockstep_link.cpp lib_ht3216C/pong.cpp
+//         lib_ht3216C/lockstep.cpp lib_ht3216C/crc.cpp lib_ht3216C/ht3216C.cpp lib_ht3216C/drawables.cpp -lutil
+//     ./lockstep_link [points] [delay_ms] [loss_percent] [tick_ms]
+//
+// Two boards run in two processes, one on each side of a pty, just like main.cpp runs link play.
+// Every board receives through a uart shim that delays every byte by delay_ms and loses loss_percent of the bytes.
+// Both boards run the game of main.cpp: the game and player classes, driven by link_game with rollback.
+// After every point a board pauses a few ticks and resets the ball, like main.cpp, until points points are made.
+// The buttons of both boards are random, but the same in every run.
+// At the end both boards have to have the same state, otherwise this program exits with 1.
+// It prints the score, the bytes send per tick, and the time from sending a button until it is shown:
+// local is on the own board, remote is on the other board, with the right buttons of both boards.
+
+#include "pong.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <fcntl.h>
+#include <pty.h>
+#include <random>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+// the uart shim of one board.
+static int port = -1;
+static int delay_us = 0;
+static int loss_percent = 0;
+static std::mt19937 loss_random;
+static std::deque<std::pair<uint_fast64_t, uint8_t>> arriving;
+static long bytes_send = 0;
+
+uint_fast64_t hwlib::now_us(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+void hwlib::wait_ns(int_fast32_t){}
+void hwlib::wait_us(int_fast32_t us){
+    usleep(us);
+}
+void hwlib::wait_ms(int_fast32_t ms){
+    usleep(ms * 1000);
+}
+bool hwlib::uart_char_available(){
+    uint8_t buffer[64];
+    ssize_t n;
+    while((n = read(port, buffer, sizeof(buffer))) > 0){
+        for(ssize_t i = 0; i < n; i++){
+            if((int)(loss_random() % 100) >= loss_percent){
+                arriving.emplace_back(now_us() + delay_us, buffer[i]);
+            }
+        }
+    }
+    if(!arriving.empty() && arriving.front().first <= now_us()){
+        return true;
+    }
+    // don't take the cpu from the other board while waiting.
+    usleep(100);
+    return false;
+}
+char hwlib::uart_getc(){
+    while(!uart_char_available()){}
+    uint8_t byte = arriving.front().second;
+    arriving.pop_front();
+    return byte;
+}
+void hwlib::uart_putc(char c){
+    // a board that has stopped doesn't read anymore, like a real uart the byte is then lost instead of waiting.
+    if(write(port, &c, 1) != 1 && errno == EINTR){
+        write(port, &c, 1);
+    }
+    bytes_send++;
+}
+
+// the state of the game of a board.
+struct state{
+    game::state ball;
+    player::state first;
+    player::state second;
+    bool operator==(const state & other) const {
+        return ball.location == other.ball.location && ball.speed == other.ball.speed
+               && ball.p1 == other.ball.p1 && ball.p2 == other.ball.p2 && ball.point == other.ball.point
+               && first.location == other.first.location && first.end == other.first.end
+               && second.location == other.second.location && second.end == other.second.end;
+    }
+};
+
+// what one board sends back to the test.
+struct report{
+    state end;
+    long ticks = 0;
+    long bytes = 0;
+    long points = 0;
+    long frames = 0;
+    long wrong = 0;
+};
+
+// the ticks a board pauses after a point, main.cpp shows the scores meanwhile.
+static const int pause_ticks = 5;
+// the frames that are timed, a frame after this is run but not timed.
+static const uint32_t timed_frames = 100000;
+
+// the buttons of a board, they change every few frames.
+static uint8_t buttons(bool host, uint32_t f){
+    std::mt19937 random((host ? 1000003u : 2000003u) + f / 4);
+    return random() % 4;
+}
+
+// the boards that have made all points, shared by both processes.
+static std::atomic<int> * finished = nullptr;
+
+static void board(bool host, long points, int tick_ms, int output){
+    hwlib::pin_in_out pin;
+    ht3216C chip(pin, pin, pin);
+    window w(hwlib::xy(16, 24), chip);
+    lockstep link;
+    link_buttons remote;
+    // the same objects as in main.cpp.
+    player player1(remote.first_hoog, remote.first_laag, w, hwlib::xy(6,0), hwlib::xy(10,0), hwlib::xy(1,-1));
+    player player2(remote.second_hoog, remote.second_laag, w, hwlib::xy(6,23), hwlib::xy(10,23), hwlib::xy(1,-1));
+    hwlib::xy start_location = {12, 8};
+    game bal(w, start_location, hwlib::xy(1,1), hwlib::xy(1,1));
+    link_game match(link, host, bal, player1, player2, remote);
+
+    std::vector<int64_t> sent(timed_frames, -1), run(timed_frames, -1), shown(timed_frames, -1);
+    report result;
+    uint32_t remote_shown = 0;
+    uint32_t newest = 0;
+    bool done = false;
+    long extra = 0;
+    // after the last point the board keeps sending until the other board is done too, and a few ticks more.
+    // a board that doesn't get there within 200 ticks per point is stuck.
+    while(extra < 5 && result.ticks < points * 200){
+        uint32_t f = link.current();
+        if(f < timed_frames && sent[f] < 0){
+            sent[f] = hwlib::now_us();
+        }
+        if(done){
+            link.send(buttons(host, f));
+            link.wait_ms(tick_ms);
+        } else if(match.tick(buttons(host, f), tick_ms)){
+            result.points++;
+            for(int i = 0; i < pause_ticks; i++){
+                link.wait_ms(tick_ms);
+            }
+            bal.reset_game(start_location);
+        }
+        // frames that have been run for the first time.
+        for(; newest < link.current(); newest++){
+            if(newest < timed_frames && run[newest] < 0){
+                run[newest] = hwlib::now_us();
+            }
+        }
+        // a frame is shown with the right buttons of the other board once it is confirmed and run.
+        while(remote_shown < link.current() && link.is_confirmed(remote_shown)){
+            // the test knows the buttons of the other board, a damaged packet that passed the crc shows here.
+            if(link.remote_input(remote_shown) != buttons(!host, remote_shown)){
+                result.wrong++;
+            }
+            if(remote_shown < timed_frames){
+                shown[remote_shown] = hwlib::now_us();
+            }
+            remote_shown++;
+        }
+        result.ticks++;
+        if(!done && result.points >= points){
+            done = true;
+            result.end = {bal.save(), player1.save(), player2.save()};
+            result.frames = link.current();
+            (*finished)++;
+        }
+        if(*finished == 2){
+            extra++;
+        }
+    }
+    result.bytes = bytes_send;
+    auto put = [&](const void * data, size_t size){
+        const char * bytes = static_cast<const char *>(data);
+        while(size > 0){
+            ssize_t n = write(output, bytes, size);
+            if(n <= 0){
+                _exit(2);
+            }
+            bytes += n;
+            size -= n;
+        }
+    };
+    put(&result, sizeof(result));
+    put(sent.data(), timed_frames * sizeof(int64_t));
+    put(run.data(), timed_frames * sizeof(int64_t));
+    put(shown.data(), timed_frames * sizeof(int64_t));
+    close(output);
+    _exit(0);
+}
+
+struct collected{
+    report result;
+    std::vector<int64_t> sent, run, shown;
+};
+
+static bool take(int input, collected & c){
+    const uint32_t frames = timed_frames;
+    auto get = [&](void * data, size_t size){
+        char * bytes = static_cast<char *>(data);
+        while(size > 0){
+            ssize_t n = read(input, bytes, size);
+            if(n <= 0){
+                return false;
+            }
+            bytes += n;
+            size -= n;
+        }
+        return true;
+    };
+    c.sent.resize(frames);
+    c.run.resize(frames);
+    c.shown.resize(frames);
+    return get(&c.result, sizeof(c.result)) && get(c.sent.data(), frames * sizeof(int64_t))
+           && get(c.run.data(), frames * sizeof(int64_t)) && get(c.shown.data(), frames * sizeof(int64_t));
+}
+
+static void print_latency(const char * name, const std::vector<int64_t> & from, const std::vector<int64_t> & to){
+    std::vector<double> ms;
+    for(size_t f = 0; f < from.size(); f++){
+        if(from[f] >= 0 && to[f] >= 0){
+            ms.push_back((to[f] - from[f]) / 1000.0);
+        }
+    }
+    if(ms.empty()){
+        std::printf("  %-14s no frames\n", name);
+        return;
+    }
+    std::sort(ms.begin(), ms.end());
+    double sum = 0;
+    for(double m : ms){
+        sum += m;
+    }
+    std::printf("  %-14s mean %6.1f ms  median %6.1f ms  p95 %6.1f ms  max %6.1f ms\n", name,
+                sum / ms.size(), ms[ms.size() / 2], ms[ms.size() * 95 / 100], ms.back());
+}
+
+int main(int argc, char ** argv){
+    long points = (argc > 1) ? std::atol(argv[1]) : 3;
+    delay_us = ((argc > 2) ? std::atoi(argv[2]) : 0) * 1000;
+    loss_percent = (argc > 3) ? std::atoi(argv[3]) : 0;
+    int tick_ms = (argc > 4) ? std::atoi(argv[4]) : 50;
+    if(points <= 0 || tick_ms <= 0){
+        std::fprintf(stderr, "usage: %s [points] [delay_ms] [loss_percent] [tick_ms]\n", argv[0]);
+        return 2;
+    }
+
+    void * shared = mmap(nullptr, sizeof(std::atomic<int>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(shared == MAP_FAILED){
+        std::perror("mmap");
+        return 2;
+    }
+    finished = new(shared) std::atomic<int>(0);
+
+    int master, slave;
+    if(openpty(&master, &slave, nullptr, nullptr, nullptr) != 0){
+        std::perror("openpty");
+        return 2;
+    }
+    termios raw{};
+    tcgetattr(slave, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(slave, TCSANOW, &raw);
+
+    int results[2][2];
+    pid_t children[2];
+    for(int b = 0; b < 2; b++){
+        if(pipe(results[b]) != 0){
+            std::perror("pipe");
+            return 2;
+        }
+        children[b] = fork();
+        if(children[b] == 0){
+            close(results[b][0]);
+            port = (b == 0) ? master : slave;
+            close((b == 0) ? slave : master);
+            fcntl(port, F_SETFL, fcntl(port, F_GETFL) | O_NONBLOCK);
+            loss_random.seed(b + 1);
+            board(b == 0, points, tick_ms, results[b][1]);
+        }
+        close(results[b][1]);
+    }
+    close(master);
+    close(slave);
+
+    collected boards[2];
+    bool complete = true;
+    for(int b = 0; b < 2; b++){
+        complete &= take(results[b][0], boards[b]);
+        int status;
+        waitpid(children[b], &status, 0);
+    }
+    if(!complete){
+        std::fprintf(stderr, "a board didn't report\n");
+        return 2;
+    }
+
+    bool same = finished->load() == 2 && boards[0].result.end == boards[1].result.end
+                && boards[0].result.frames == boards[1].result.frames;
+    std::printf("%ld points, %d ms ticks, %d ms delay, %d%% loss: %s\n", points, tick_ms, delay_us / 1000, loss_percent,
+                (finished->load() < 2) ? "a board got STUCK" : same ? "both boards end in the same state" : "the boards DIFFER");
+    for(int b = 0; b < 2; b++){
+        const report & r = boards[b].result;
+        std::printf("board %d: score %d-%d after %ld frames, ball (%d,%d) paddles %d %d, %.1f bytes per tick, %ld wrong buttons received\n",
+                    b, r.end.ball.p1, r.end.ball.p2, r.frames, (int)r.end.ball.location.x, (int)r.end.ball.location.y,
+                    (int)r.end.first.location.x, (int)r.end.second.location.x, double(r.bytes) / r.ticks, r.wrong);
+    }
+    for(int b = 0; b < 2; b++){
+        std::printf("input of board %d:\n", b);
+        print_latency("local", boards[b].sent, boards[b].run);
+        print_latency("remote", boards[b].sent, boards[1 - b].shown);
+    }
+    return same ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+// Loopback test for the uart receive mode, see frame_receiver in lib_ht3216C/stream.hpp.
+//
+// This is a host program, it is not part of the firmware build:
+//     g++ -std=c++17 -O2 -Ilib_ht3216C -o frame_sender tools/frame_sender.cpp lib_ht3216C/crc.cpp
+//     g++ -std=c++17 -O2 -Itools/host -Ilib_ht3216C -o stream_loopback tools/stream_loopback.cpp
+//         lib_ht3216C/stream.cpp lib_ht3216C/ht3216C.cpp lib_ht3216C/drawables.cpp lib_ht3216C/crc.cpp -lutil -pthread
+//     ./stream_loopback ./frame_sender [baud] [frames] [fps]
+//
+// The frame_sender writes to one side of a pty, all bytes are read from the other side with the time they arrive.
+// Then the bytes are fed to the frame_receiver through a uart shim that works like the uart of the arduino due:
+// the bytes leave the wire one byte time apart, and there is only one receive register,
+// a byte that arrives while it is full is lost.
+// The receiver runs on a simulated clock: a pin write takes pin_ns, a wait takes as long as it asks
+// and every uart poll takes poll_ns. So a flush takes as long as on the arduino, and the host can't get in between.
+// At the end the frame on the ht3216C has to be the last frame that was send, otherwise this program exits with 1.
+
+#include "stream.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <poll.h>
+#include <pty.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const int rows = 24;
+// about the time of a pin write and of one loop of frame_receiver::poll() on the arduino due.
+static const uint_fast64_t pin_ns = 150;
+static const uint_fast64_t poll_ns = 1000;
+
+// the simulated clock and the uart shim.
+static uint_fast64_t clock_ns = 0;
+static std::vector<std::pair<uint_fast64_t, uint8_t>> wire_bytes;
+static size_t next_byte = 0;
+static bool holding = false;
+static uint8_t receive_register = 0;
+static long lost = 0;
+
+uint_fast64_t hwlib::now_us(){
+    return clock_ns / 1000;
+}
+void hwlib::wait_ns(int_fast32_t ns){
+    clock_ns += ns;
+}
+void hwlib::wait_us(int_fast32_t us){
+    clock_ns += (uint_fast64_t)us * 1000;
+}
+void hwlib::wait_ms(int_fast32_t ms){
+    clock_ns += (uint_fast64_t)ms * 1000000;
+}
+bool hwlib::uart_char_available(){
+    clock_ns += poll_ns;
+    while(next_byte < wire_bytes.size() && wire_bytes[next_byte].first <= clock_ns){
+        if(holding){
+            lost++;
+        } else {
+            receive_register = wire_bytes[next_byte].second;
+            holding = true;
+        }
+        next_byte++;
+    }
+    return holding;
+}
+char hwlib::uart_getc(){
+    while(!uart_char_available()){}
+    holding = false;
+    return receive_register;
+}
+void hwlib::uart_putc(char){}
+
+// a pin that only takes time.
+class timed_pin : public hwlib::pin_in_out {
+public:
+    void write(bool) override { clock_ns += pin_ns; }
+};
+
+// an ht3216C that shows what it has written.
+class probe : public ht3216C {
+public:
+    using ht3216C::ht3216C;
+    uint16_t row(int i) const { return shown[i]; }
+};
+
+// a ball that bounces over the panel and a bar that moves down, so every frame changes a few rows.
+static void make_frame(int n, uint16_t * frame){
+    int x = n % 30;
+    x = (x < 16) ? x : 30 - x;
+    for(int row = 0; row < rows; row++){
+        frame[row] = 0;
+    }
+    frame[(n / 2) % rows] = 0xffff;
+    frame[(n * 3) % rows] |= 1u << x;
+    frame[0] |= n & 0xff;
+}
+
+int main(int argc, char ** argv){
+    if(argc < 2 || argc > 5){
+        std::fprintf(stderr, "usage: %s frame_sender [baud] [frames] [fps]\n", argv[0]);
+        return 2;
+    }
+    const char * sender = argv[1];
+    long baud = (argc > 2) ? std::atol(argv[2]) : 115200;
+    int frames = (argc > 3) ? std::atoi(argv[3]) : 200;
+    const char * fps = (argc > 4) ? argv[4] : nullptr;
+    const uint_fast64_t byte_ns = 10 * 1000000000ull / baud;
+
+    int master, slave;
+    char name[128];
+    if(openpty(&master, &slave, name, nullptr, nullptr) != 0){
+        std::perror("openpty");
+        return 2;
+    }
+    int input[2];
+    if(pipe(input) != 0){
+        std::perror("pipe");
+        return 2;
+    }
+    pid_t child = fork();
+    if(child == 0){
+        dup2(input[0], 0);
+        close(input[0]);
+        close(input[1]);
+        close(master);
+        std::string rate = std::to_string(baud);
+        if(fps){
+            execl(sender, sender, name, rate.c_str(), fps, (char *)nullptr);
+        } else {
+            execl(sender, sender, name, rate.c_str(), (char *)nullptr);
+        }
+        std::perror("exec");
+        _exit(2);
+    }
+    close(input[0]);
+
+    uint16_t last[rows];
+    std::thread writer([&](){
+        for(int n = 0; n < frames; n++){
+            make_frame(n, last);
+            uint8_t raw[rows * 2];
+            for(int row = 0; row < rows; row++){
+                raw[row * 2] = last[row] >> 8;
+                raw[row * 2 + 1] = last[row] & 0xff;
+            }
+            if(write(input[1], raw, sizeof(raw)) != (ssize_t)sizeof(raw)){
+                break;
+            }
+        }
+        close(input[1]);
+    });
+
+    // every byte leaves the wire one byte time after the byte before it.
+    auto start = std::chrono::steady_clock::now();
+    uint_fast64_t wire = 0;
+    bool exited = false;
+    for(;;){
+        pollfd ready = {master, POLLIN, 0};
+        if(poll(&ready, 1, 200) > 0){
+            uint8_t buffer[256];
+            ssize_t n = read(master, buffer, sizeof(buffer));
+            if(n <= 0){
+                break;
+            }
+            uint_fast64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            for(ssize_t i = 0; i < n; i++){
+                wire = ((wire > now) ? wire : now) + byte_ns;
+                wire_bytes.emplace_back(wire, buffer[i]);
+            }
+        } else if(exited){
+            break;
+        }
+        int status;
+        exited = exited || waitpid(child, &status, WNOHANG) == child;
+    }
+    writer.join();
+    close(slave);
+    close(master);
+
+    timed_pin pin;
+    probe matrix(pin, pin, pin);
+    frame_receiver receiver(matrix, baud);
+    long shown = 0;
+    uint_fast64_t first = 0, latest = 0;
+    while(next_byte < wire_bytes.size() || holding || clock_ns < wire + 1000000){
+        if(receiver.poll()){
+            latest = clock_ns;
+            first = first ? first : latest;
+            shown++;
+        }
+    }
+
+    bool match = true;
+    for(int row = 0; row < rows; row++){
+        match &= matrix.row(row) == last[row];
+    }
+    double seconds = (latest - first) / 1e9;
+    std::printf("%d frames send at %ld baud, %ld shown in %.3f s: %.1f frames per second, %ld bytes lost, final frame %s\n",
+                frames, baud, shown, seconds, (shown > 1 && seconds > 0) ? (shown - 1) / seconds : 0.0, lost,
+                match ? "matches" : "DIFFERS");
+    return match ? 0 : 1;
+}
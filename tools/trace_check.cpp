@@ -0,0 +1,156 @@
+// Timing checker for recorded ht3216C bus traces.
+//
+// This is a host program, it is not part of the firmware build:
+//     g++ -std=c++17 -O2 -o trace_check tools/trace_check.cpp
+//     ./trace_check trace.txt [wr_low_ns wr_high_ns setup_ns hold_ns]
+//
+// The trace is a text file with one sample per line, written each time one of the pins changes:
+//     time_ns cs wr data
+// Commas are allowed as separators, lines starting with '#' are skipped.
+// This is what a logic analyzer export looks like after removing the unused channels.
+//
+// For every rising edge of the write pin while the Chip Select pin is low, this program checks:
+// the low and high time of the write pin, and the setup and hold time of the data pin.
+// The default minimums are the same as the defaults of the timing struct in ht3216C.hpp.
+// It exits with 1 when a minimum is violated.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct sample{
+    int64_t time;
+    bool cs;
+    bool wr;
+    bool data;
+};
+
+struct limit{
+    const char * name;
+    int64_t minimum;
+    int64_t lowest = INT64_MAX;
+    int violations = 0;
+
+    void check(int64_t value, int64_t time){
+        if(value < lowest){
+            lowest = value;
+        }
+        if(value < minimum){
+            if(violations < 10){
+                std::printf("%lld ns: %s is %lld ns, minimum is %lld ns\n", (long long)time, name, (long long)value, (long long)minimum);
+            }
+            violations++;
+        }
+    }
+};
+
+static std::vector<sample> read_trace(std::istream & in){
+    std::vector<sample> trace;
+    std::string text;
+    while(std::getline(in, text)){
+        if(text.empty() || text[0] == '#'){
+            continue;
+        }
+        for(auto & c : text){
+            if(c == ','){
+                c = ' ';
+            }
+        }
+        std::istringstream fields(text);
+        long long time;
+        int cs, wr, data;
+        if(fields >> time >> cs >> wr >> data){
+            trace.push_back({time, cs != 0, wr != 0, data != 0});
+        }
+    }
+    return trace;
+}
+
+int main(int argc, char ** argv){
+    if(argc != 2 && argc != 6){
+        std::fprintf(stderr, "usage: %s trace.txt [wr_low_ns wr_high_ns setup_ns hold_ns]\n", argv[0]);
+        return 2;
+    }
+    std::ifstream file(argv[1]);
+    if(!file){
+        std::fprintf(stderr, "can't open %s\n", argv[1]);
+        return 2;
+    }
+    limit wr_low{"write low", 835};
+    limit wr_high{"write high", 835};
+    limit setup{"data setup", 500};
+    limit hold{"data hold", 500};
+    if(argc == 6){
+        wr_low.minimum = std::atoll(argv[2]);
+        wr_high.minimum = std::atoll(argv[3]);
+        setup.minimum = std::atoll(argv[4]);
+        hold.minimum = std::atoll(argv[5]);
+    }
+
+    std::vector<sample> trace = read_trace(file);
+    int64_t last_fall = -1;
+    int64_t last_rise = -1;
+    int64_t last_data = -1;
+    int64_t pending_hold = -1;
+    int64_t first_bit = -1;
+    int64_t last_bit = -1;
+    long bits = 0;
+    for(size_t i = 1; i < trace.size(); i++){
+        const sample & before = trace[i - 1];
+        const sample & now = trace[i];
+        if(now.data != before.data){
+            if(pending_hold >= 0){
+                hold.check(now.time - pending_hold, now.time);
+                pending_hold = -1;
+            }
+            last_data = now.time;
+        }
+        if(now.cs){
+            // a transaction ends with the Chip Select, the data after it doesn't matter.
+            pending_hold = -1;
+            continue;
+        }
+        if(!now.wr && before.wr){
+            if(last_rise >= 0 && !before.cs){
+                wr_high.check(now.time - last_rise, now.time);
+            }
+            last_fall = now.time;
+        }
+        if(now.wr && !before.wr){
+            if(last_fall >= 0){
+                wr_low.check(now.time - last_fall, now.time);
+            }
+            if(last_data >= 0){
+                setup.check(now.time - last_data, now.time);
+            }
+            last_rise = now.time;
+            pending_hold = now.time;
+            if(first_bit < 0){
+                first_bit = now.time;
+            }
+            last_bit = now.time;
+            bits++;
+        }
+    }
+
+    std::printf("%ld bits\n", bits);
+    for(const limit * l : {&wr_low, &wr_high, &setup, &hold}){
+        if(l->lowest == INT64_MAX){
+            std::printf("%-10s: not seen\n", l->name);
+        } else {
+            std::printf("%-10s: lowest %lld ns, minimum %lld ns, %d violations\n",
+                        l->name, (long long)l->lowest, (long long)l->minimum, l->violations);
+        }
+    }
+    if(bits > 1){
+        double bit_ns = double(last_bit - first_bit) / double(bits - 1);
+        std::printf("bit time : %.0f ns, a full flush of 394 bits takes %.1f us\n", bit_ns, bit_ns * 394 / 1000);
+    }
+    int violations = wr_low.violations + wr_high.violations + setup.violations + hold.violations;
+    return violations ? 1 : 0;
+}
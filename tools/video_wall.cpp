@@ -0,0 +1,163 @@
+#include "video_wall.hpp"
+
+render_pool::render_pool(int threads){
+    threads = (threads > 0) ? threads : 1;
+    for(int i = 0; i < threads; i++){
+        queues.emplace_back(new worker_queue);
+    }
+    for(int i = 0; i < threads; i++){
+        workers.emplace_back(&render_pool::work, this, i);
+    }
+}
+render_pool::~render_pool(){
+    {
+        std::lock_guard< std::mutex > guard(lock);
+        stopping = true;
+    }
+    start.notify_all();
+    for(auto & worker : workers){
+        worker.join();
+    }
+}
+int render_pool::size() const{
+    return workers.size();
+}
+bool render_pool::take(int self, int & number){
+    int count = queues.size();
+    {
+        worker_queue & own = *queues[self];
+        std::lock_guard< std::mutex > guard(own.lock);
+        if(!own.jobs.empty()){
+            number = own.jobs.back();
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+    for(int i = 1; i < count; i++){
+        worker_queue & other = *queues[(self + i) % count];
+        std::lock_guard< std::mutex > guard(other.lock);
+        if(!other.jobs.empty()){
+            number = other.jobs.front();
+            other.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+void render_pool::work(int self){
+    uint64_t seen = 0;
+    for(;;){
+        {
+            std::unique_lock< std::mutex > guard(lock);
+            start.wait(guard, [&]{ return stopping || generation != seen; });
+            if(stopping){
+                return;
+            }
+            seen = generation;
+        }
+        int number;
+        while(take(self, number)){
+            job(number);
+        }
+        {
+            std::lock_guard< std::mutex > guard(lock);
+            busy--;
+        }
+        done.notify_all();
+    }
+}
+void render_pool::run(int number, const std::function< void(int) > & job){
+    // the jobs are handed out in order, neighbouring jobs end up on different workers.
+    for(int i = 0; i < number; i++){
+        worker_queue & queue = *queues[i % queues.size()];
+        std::lock_guard< std::mutex > guard(queue.lock);
+        queue.jobs.push_back(i);
+    }
+    std::unique_lock< std::mutex > guard(lock);
+    this->job = job;
+    busy = workers.size();
+    generation++;
+    start.notify_all();
+    done.wait(guard, [&]{ return busy == 0; });
+}
+
+// the tile the calling thread renders, nullptr outside render().
+static thread_local tile * target = nullptr;
+static thread_local hwlib::xy target_origin;
+
+video_wall::video_wall(hwlib::xy panels):
+        hwlib::window(hwlib::xy(panels.x * commands::row, panels.y * commands::com)),
+        panels(panels),
+        tiles(panels.x * panels.y){}
+
+int video_wall::number_of_tiles() const{
+    return tiles.size();
+}
+hwlib::xy video_wall::origin(int t) const{
+    return hwlib::xy((t % panels.x) * commands::row, (t / panels.x) * commands::com);
+}
+bool video_wall::overlaps(int t, drawable & object) const{
+    hwlib::xy start = object.get_location();
+    hwlib::xy end = start + object.get_size();
+    hwlib::xy low(start.x < end.x ? start.x : end.x, start.y < end.y ? start.y : end.y);
+    hwlib::xy high(start.x < end.x ? end.x : start.x, start.y < end.y ? end.y : start.y);
+    hwlib::xy first = origin(t);
+    return (high.x >= first.x) && (low.x < first.x + commands::row)
+           && (high.y >= first.y) && (low.y < first.y + commands::com);
+}
+void video_wall::render_tile(int t, const std::vector< drawable * > & objects){
+    tile & current = tiles[t];
+    for(int i = 0; i < commands::com; i++){
+        current.rows[i] = 0x0000;
+    }
+    target = &current;
+    target_origin = origin(t);
+    for(drawable * object : objects){
+        if(overlaps(t, *object)){
+            object->draw();
+        }
+    }
+    target = nullptr;
+    current.dirty = false;
+    for(int i = 0; i < commands::com; i++){
+        if(current.rows[i] != current.rendered[i]){
+            current.dirty = true;
+            current.rendered[i] = current.rows[i];
+        }
+    }
+}
+void video_wall::write_implementation(hwlib::xy pixel, hwlib::color col){
+    if(target == nullptr || col == hwlib::black){
+        return;
+    }
+    hwlib::xy local = pixel - target_origin;
+    if(local.x < 0 || local.y < 0 || local.x >= commands::row || local.y >= commands::com){
+        return;
+    }
+    target->rows[local.y] |= 0x0001 << local.x;
+}
+void video_wall::attach(int t, ht3216C & panel){
+    if(t >= 0 && t < number_of_tiles()){
+        tiles[t].panel = &panel;
+    }
+}
+void video_wall::render(render_pool & pool, const std::vector< drawable * > & objects){
+    pool.run(number_of_tiles(), [&](int t){
+        render_tile(t, objects);
+    });
+}
+bool video_wall::dirty(int t) const{
+    return (t >= 0 && t < number_of_tiles()) ? tiles[t].dirty : false;
+}
+const uint16_t * video_wall::rendered(int t) const{
+    return tiles[t].rendered;
+}
+void video_wall::flush(){
+    for(auto & current : tiles){
+        if(current.dirty && current.panel != nullptr){
+            current.panel->change_window(current.rendered);
+            current.panel->flush();
+            current.dirty = false;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// Video wall for the host, see tools/wall_bench.cpp for a benchmark.
+//
+// This is host code, it is not part of the firmware build:
+// the tiles of a wall are rendered in parallel, and the arduino due has only one core.
+// The drawables of lib_ht3216C are drawn on it, with tools/host/hwlib.hpp as hwlib.
+
+#ifndef VIDEO_WALL_H
+#define VIDEO_WALL_H
+
+#include "hwlib.hpp"
+#include "ht3216C.hpp"
+#include "drawables.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \brief
+/// This class runs jobs on a fixed number of threads
+/// \details
+/// Every worker has its own deque of jobs. run() spreads the jobs evenly over the deques,
+/// a worker takes jobs from the back of its own deque, and when that is empty it steals from the front of the others.
+/// So a worker that got the cheap jobs helps the worker that got the expensive ones.
+/// run() returns when all jobs are done.
+class render_pool{
+protected:
+    struct worker_queue{
+        std::mutex lock;
+        std::deque< int > jobs;
+    };
+    std::vector< std::unique_ptr< worker_queue > > queues;
+    std::vector< std::thread > workers;
+    std::mutex lock;
+    std::condition_variable start;
+    std::condition_variable done;
+    std::function< void(int) > job;
+    uint64_t generation = 0;
+    int busy = 0;
+    bool stopping = false;
+    /// \brief
+    /// this function takes a job, first from the own deque, then from the others.
+    /// @returns false when all deques are empty.
+    bool take(int self, int & number);
+    /// \brief
+    /// this function is the loop of one worker.
+    void work(int self);
+public:
+    /// \brief
+    /// this constructor starts the workers.
+    /// @param threads is the number of workers, at least 1.
+    render_pool(int threads);
+    /// \brief
+    /// this destructor stops the workers.
+    ~render_pool();
+    /// \brief
+    /// this function returns the number of workers.
+    int size() const;
+    /// \brief
+    /// this function runs job(0) up to job(number - 1) on the workers, and waits until they are all done.
+    void run(int number, const std::function< void(int) > & job);
+};
+
+/// \brief
+/// This struct is one panel of a video_wall
+/// \details
+/// A tile has its own rows, just like the window of the ht3216C.
+/// rendered are the rows of the last render, dirty is true when the last render changed them.
+struct tile{
+    uint16_t rows[24] = {0};
+    uint16_t rendered[24] = {0};
+    bool dirty = false;
+    ht3216C * panel = nullptr;
+};
+
+/// \brief
+/// This class is a window made of more than one ht3216C panel
+/// \details
+/// The window is split in tiles of 16 by 24 pixels, one tile for every panel.
+/// render() draws the drawables tile by tile on the threads of a render_pool: a drawable is only drawn
+/// on the tiles it overlaps, and everything outside the tile is clipped. Afterwards flush() only writes the panels that have changed.
+/// The drawables need to be made with this window.
+/// While rendering, every thread writes to the tile it renders. Pixels written outside render() are ignored,
+/// the next render would clear them anyway.
+/// @note the drawables are only read while rendering, update them before render().
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+/// render_pool pool(4);
+/// video_wall wall(hwlib::xy(2, 1));
+/// wall.attach(0, left);
+/// wall.attach(1, right);
+/// circle ball(wall, hwlib::xy(16, 12), 5);
+/// std::vector<drawable *> objects = {&ball};
+/// wall.render(pool, objects);
+/// wall.flush();
+///~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// @see tile render_pool ht3216C
+class video_wall : public hwlib::window{
+protected:
+    hwlib::xy panels;
+    std::vector< tile > tiles;
+    /// \brief
+    /// this function returns the top left pixel of a tile.
+    hwlib::xy origin(int t) const;
+    /// \brief
+    /// this function returns true when a drawable overlaps a tile.
+    bool overlaps(int t, drawable & object) const;
+    /// \brief
+    /// this function renders one tile.
+    /// \details
+    /// The rows of the tile are emptied, and every drawable that overlaps the tile is drawn, clipped to the tile.
+    /// Afterwards dirty tells if the rows are different from the last render.
+    void render_tile(int t, const std::vector< drawable * > & objects);
+    /// \brief
+    /// this function writes a pixel in the tile that the calling thread renders.
+    void write_implementation(hwlib::xy pixel, hwlib::color col) override;
+public:
+    /// \brief
+    /// this constructor sets up the video wall.
+    /// @param panels is the number of panels in x and y.
+    video_wall(hwlib::xy panels);
+    /// \brief
+    /// this function returns the number of tiles.
+    int number_of_tiles() const;
+    /// \brief
+    /// this function connects a panel to a tile.
+    /// @param t is the number of the tile, counted from left to right and top to bottom.
+    /// @param panel is the ht3216C of the tile.
+    void attach(int t, ht3216C & panel);
+    /// \brief
+    /// this function renders all the tiles, one job per tile.
+    /// @param pool are the threads that render.
+    /// @param objects are the drawables to render.
+    /// @see render_tile()
+    void render(render_pool & pool, const std::vector< drawable * > & objects);
+    /// \brief
+    /// this function returns true when the last render changed the tile.
+    bool dirty(int t) const;
+    /// \brief
+    /// this function returns the rows of the last render of a tile.
+    const uint16_t * rendered(int t) const;
+    /// \brief
+    /// this function writes every dirty tile to its panel.
+    /// @see ht3216C::change_window() ht3216C::flush()
+    void flush() override;
+};
+
+#endif // VIDEO_WALL_H
@@ -0,0 +1,120 @@
+// Benchmark of the video wall renderer, see tools/video_wall.hpp.
+//
+// This is a host program, it is not part of the firmware build:
+//     g++ -std=c++17 -O2 -Itools/host -Ilib_ht3216C -o wall_bench tools/wall_bench.cpp tools/video_wall.cpp
+//         lib_ht3216C/drawables.cpp lib_ht3216C/ht3216C.cpp -pthread
+//     ./wall_bench [frames] [balls per panel]
+//
+// Balls bounce over walls of different sizes, and every frame all tiles are rendered.
+// Half of the balls stay in the left quarter of the wall, so some tiles are much more work than others.
+// For every wall size and number of threads the frames and tiles per second are printed,
+// and the rendered tiles are checked against a render with one thread.
+
+#include "video_wall.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+void hwlib::wait_ns(int_fast32_t){}
+void hwlib::wait_us(int_fast32_t){}
+void hwlib::wait_ms(int_fast32_t){}
+uint_fast64_t hwlib::now_us(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+bool hwlib::uart_char_available(){ return false; }
+char hwlib::uart_getc(){ return 0; }
+void hwlib::uart_putc(char){}
+
+// a circle that moves and bounces inside an area of the wall.
+class ball : public circle {
+    hwlib::xy speed;
+    hwlib::xy area;
+public:
+    ball(hwlib::window & w, hwlib::xy center, int radius, hwlib::xy speed, hwlib::xy area):
+            circle(w, center, radius), speed(speed), area(area){}
+    void update() override {
+        location = location + speed;
+        if(location.x < 0 || location.x + size.x >= area.x){
+            speed.x = -speed.x;
+        }
+        if(location.y < 0 || location.y + size.y >= area.y){
+            speed.y = -speed.y;
+        }
+    }
+};
+
+struct scene{
+    video_wall wall;
+    std::vector< std::unique_ptr< drawable > > owned;
+    std::vector< drawable * > objects;
+    scene(hwlib::xy panels, int balls_per_panel): wall(panels){
+        hwlib::xy size = wall.size;
+        int balls = panels.x * panels.y * balls_per_panel;
+        unsigned seed = 12345;
+        auto random = [&](int range){
+            seed = seed * 1103515245 + 12345;
+            return (int)((seed >> 16) % (range > 0 ? range : 1));
+        };
+        for(int i = 0; i < balls; i++){
+            // half of the balls stay in the left quarter, those tiles are busy.
+            hwlib::xy area = (i % 2) ? size : hwlib::xy(size.x / 4 > 8 ? size.x / 4 : 8, size.y);
+            int radius = 1 + random(3);
+            hwlib::xy center(radius + random(area.x - 2 * radius - 1), radius + random(area.y - 2 * radius - 1));
+            hwlib::xy speed(1 + random(2), 1 + random(2));
+            owned.emplace_back(new ball(wall, center, radius, speed, area));
+        }
+        owned.emplace_back(new rectangle(wall, hwlib::xy(0, 0), size - hwlib::xy(1, 1)));
+        for(auto & object : owned){
+            objects.push_back(object.get());
+        }
+    }
+    void update(){
+        for(auto & object : owned){
+            object->update();
+        }
+    }
+};
+
+int main(int argc, char ** argv){
+    int frames = (argc > 1) ? std::atoi(argv[1]) : 200;
+    int balls_per_panel = (argc > 2) ? std::atoi(argv[2]) : 4;
+    const hwlib::xy walls[] = {hwlib::xy(2, 2), hwlib::xy(4, 4), hwlib::xy(8, 8), hwlib::xy(16, 16)};
+    const int thread_counts[] = {1, 2, 4, 8};
+    unsigned hardware = std::thread::hardware_concurrency();
+    std::printf("%d frames, %d balls per panel, %u hardware threads\n", frames, balls_per_panel, hardware);
+    std::printf("%8s %8s %12s %14s %8s\n", "panels", "threads", "frames/s", "tiles/s", "speedup");
+    bool same = true;
+    for(auto panels : walls){
+        // the render with one thread is the reference.
+        std::vector< uint16_t > reference;
+        double single = 0;
+        for(int threads : thread_counts){
+            scene test(panels, balls_per_panel);
+            render_pool pool(threads);
+            std::vector< uint16_t > result;
+            auto start = std::chrono::steady_clock::now();
+            for(int f = 0; f < frames; f++){
+                test.update();
+                test.wall.render(pool, test.objects);
+            }
+            double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+            for(int t = 0; t < test.wall.number_of_tiles(); t++){
+                result.insert(result.end(), test.wall.rendered(t), test.wall.rendered(t) + commands::com);
+            }
+            if(threads == 1){
+                reference = result;
+                single = seconds;
+            } else if(result != reference){
+                same = false;
+                std::printf("render with %d threads differs\n", threads);
+            }
+            int tiles = test.wall.number_of_tiles();
+            std::printf("%8d %8d %12.1f %14.1f %7.2fx\n", tiles, threads, frames / seconds,
+                        double(frames) * tiles / seconds, single / seconds);
+        }
+    }
+    return same ? 0 : 1;
+}